@@ -0,0 +1,109 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "latbuilder/CoordUniformFigureOfMerit.h"
+#include "latticetester/ProductWeights.h"
+#include "latbuilder/Kernel/PAlpha.h"
+#include "latbuilder/Storage.h"
+
+#include "latbuilder/MeritSeq/CoordUniformCBC.h"
+#include "latbuilder/MeritSeq/CoordUniformInnerProd.h"
+#include "latbuilder/MeritSeq/CoordUniformInnerProdFastCRT.h"
+#include "latbuilder/GenSeq/GeneratingValues.h"
+#include "latbuilder/GenSeq/Creator.h"
+
+#include "latbuilder/TextStream.h"
+
+#include "Path.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+using namespace LatBuilder;
+using TextStream::operator<<;
+
+template <typename T, typename... ARGS>
+std::unique_ptr<T> unique(ARGS&&... args)
+{ return std::unique_ptr<T>(new T(std::forward<ARGS>(args)...)); }
+
+// Compares the fast CBC for composite numbers of points with the standard CBC.
+void test(const Storage<LatticeType::ORDINARY, EmbeddingType::UNILEVEL, Compress::SYMMETRIC>& storage, Dimension dimension)
+{
+   auto weights = unique<LatticeTester::ProductWeights>();
+   weights->setDefaultWeight(0.7);
+
+   CoordUniformFigureOfMerit<Kernel::PAlpha> figure(std::move(weights), 2);
+
+   std::cout << "number of points: " << storage.sizeParam().numPoints() << std::endl;
+
+   //! [Coprime]
+   typedef GenSeq::GeneratingValues<LatticeType::ORDINARY, decltype(figure)::suggestedCompression()> Coprime;
+   //! [Coprime]
+   auto genSeq  = GenSeq::Creator<Coprime>::create(storage.sizeParam());
+   auto genSeq0 = GenSeq::Creator<Coprime>::create(SizeParam<LatticeType::ORDINARY, EmbeddingType::UNILEVEL>(LatticeTraits<LatticeType::ORDINARY>::TrivialModulus));
+
+   //! [cbc]
+   auto fast = MeritSeq::cbc<MeritSeq::CoordUniformInnerProdFastCRT>(storage, figure);
+   //! [cbc]
+   auto standard = MeritSeq::cbc<MeritSeq::CoordUniformInnerProd>(storage, figure);
+
+   while (standard.baseLat().dimension() < dimension) {
+
+      Dimension baseDim = standard.baseLat().dimension();
+
+      auto fastSeq = fast.meritSeq(baseDim == 0 ? genSeq0 : genSeq);
+      auto standardSeq = standard.meritSeq(baseDim == 0 ? genSeq0 : genSeq);
+
+      // walk through both sequences and keep the best candidate of the
+      // standard CBC
+      size_t count = 0;
+      Real maxDiff = 0.0;
+      auto itFast = fastSeq.begin();
+      auto bestFast = itFast;
+      auto bestStandard = standardSeq.begin();
+      for (auto it = standardSeq.begin(); it != standardSeq.end(); ++it, ++itFast) {
+         maxDiff = std::max(maxDiff, std::abs(*itFast - *it) / *it);
+         if (*it < *bestStandard) {
+            bestStandard = it;
+            bestFast = itFast;
+         }
+         count++;
+      }
+
+      fast.select(bestFast);
+      standard.select(bestStandard);
+
+      std::cout << "  dimension " << (baseDim + 1) << ": " << count << " candidates, "
+         << (maxDiff < 1e-10 ? "fast CRT and standard CBC agree" : "fast CRT and standard CBC DIFFER")
+         << std::endl;
+   }
+
+   std::cout << "  same generating vector: " << (fast.baseLat().gen() == standard.baseLat().gen() ? "yes" : "no") << std::endl;
+}
+
+int main()
+{
+   SET_PATH_TO_LATNETBUILDER_FOR_EXAMPLES();
+   Dimension dim = 4;
+
+   //! [storage]
+   test(Storage<LatticeType::ORDINARY, EmbeddingType::UNILEVEL, Compress::SYMMETRIC>(60), dim);
+   test(Storage<LatticeType::ORDINARY, EmbeddingType::UNILEVEL, Compress::SYMMETRIC>(1000), dim);
+   //! [storage]
+
+   return 0;
+}
@@ -0,0 +1,95 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "netbuilder/Types.h"
+#include "netbuilder/NetConstructionTraits.h"
+#include "netbuilder/GeneratingMatrix.h"
+#include "netbuilder/Helpers/CyclicInnerProd.h"
+
+#include "latbuilder/Kernel/PAlphaTilde.h"
+#include "latbuilder/MeritSeq/CoordUniformInnerProd.h"
+#include "latbuilder/Storage.h"
+#include "latbuilder/Util.h"
+
+#include "Path.h"
+
+using namespace NetBuilder;
+using LatBuilder::PolynomialFromInt;
+
+typedef LatBuilder::Storage<LatBuilder::LatticeType::DIGITAL, LatBuilder::EmbeddingType::UNILEVEL, LatBuilder::Compress::NONE, LatBuilder::PerLevelOrder::BASIC> Storage;
+typedef LatBuilder::MeritSeq::CoordUniformInnerProd<LatBuilder::LatticeType::DIGITAL, LatBuilder::EmbeddingType::UNILEVEL, LatBuilder::Compress::NONE, LatBuilder::PerLevelOrder::BASIC> InnerProd;
+
+// Compares the inner products computed at once by CyclicInnerProd with those computed
+// one polynomial at a time by CoordUniformInnerProd, for all the polynomials modulo modulus.
+void test(const Polynomial& modulus)
+{
+    std::cout << "Modulus: " << modulus << std::endl;
+
+    const unsigned int m = (unsigned int) deg(modulus);
+    const uInteger size = uInteger(1) << m;
+
+    Storage storage(LatBuilder::SizeParam<LatBuilder::LatticeType::DIGITAL, LatBuilder::EmbeddingType::UNILEVEL>(size));
+    InnerProd innerProd(storage, LatBuilder::Kernel::PAlphaTilde(2));
+    const RealVector& kernelValues = innerProd.kernelValues();
+
+    // state of the first coordinate for product weights of 0.7
+    RealVector state(size);
+    for (uInteger i = 0; i < size; ++i)
+    {
+        state[i] = 0.7 * (1 + 0.7 * kernelValues[i]);
+    }
+
+    //! [cyclic]
+    CyclicInnerProd cyclicProd;
+    if (!cyclicProd.init(modulus, kernelValues))
+    {
+        std::cout << "  reducible modulus: cyclic inner products not available" << std::endl;
+        return;
+    }
+    cyclicProd.computeProducts(state);
+    //! [cyclic]
+
+    // bound on the magnitude of the inner products
+    const Real scale = boost::numeric::ublas::norm_1(state) * boost::numeric::ublas::norm_inf(kernelValues);
+
+    Real maxDiff = 0;
+    for (uInteger q = 1; q < size; ++q)
+    {
+        std::unique_ptr<GeneratingMatrix> matrix(NetConstructionTraits<NetConstruction::POLYNOMIAL>::createGeneratingMatrix(PolynomialFromInt(q), modulus));
+        std::vector<GeneratingMatrix> genSeq {*matrix};
+        const Real expected = *(innerProd.prodSeq(genSeq, state).begin());
+        maxDiff = std::max(maxDiff, std::abs(cyclicProd.product(*matrix) - expected) / scale);
+    }
+
+    std::cout << "  " << (size - 1) << " polynomials, "
+        << (maxDiff < 1e-10 ? "cyclic and standard inner products agree" : "cyclic and standard inner products DIFFER")
+        << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    SET_PATH_TO_LATNETBUILDER_FOR_EXAMPLES();
+
+    test(PolynomialFromInt(283));
+    test(PolynomialFromInt(1033));
+    test(PolynomialFromInt(1025));
+}
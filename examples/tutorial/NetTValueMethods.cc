@@ -0,0 +1,197 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdint>
+
+#include "netbuilder/Types.h"
+#include "netbuilder/GeneratingMatrix.h"
+#include "netbuilder/Helpers/JoeKuo.h"
+#include "netbuilder/FigureOfMerit/TValueComputation.h"
+
+#include "Path.h"
+
+using namespace NetBuilder;
+using JoeKuo::createJoeKuoSobolNet;
+
+// Returns whether the first counts[i] rows of the matrices i are linearly independent, by plain gaussian elimination.
+bool independentRows(const std::vector<const GeneratingMatrix*>& matrices, const std::vector<unsigned int>& counts)
+{
+    std::vector<std::uint64_t> rows;
+    for (unsigned int i = 0; i < matrices.size(); ++i)
+    {
+        for (unsigned int r = 0; r < counts[i]; ++r)
+        {
+            std::uint64_t row = 0;
+            for (unsigned int c = 0; c < matrices[i]->nCols(); ++c)
+            {
+                if ((*matrices[i])(r, c))
+                {
+                    row |= std::uint64_t(1) << c;
+                }
+            }
+            for (std::uint64_t other : rows)
+            {
+                row = std::min(row, row ^ other);
+            }
+            if (row == 0)
+            {
+                return false;
+            }
+            rows.push_back(row);
+            std::sort(rows.rbegin(), rows.rend());
+        }
+    }
+    return true;
+}
+
+// Returns whether all the compositions of k rows among the matrices from position i on give independent rows.
+bool allCompositionsIndependent(const std::vector<const GeneratingMatrix*>& matrices, std::vector<unsigned int>& counts, unsigned int i, unsigned int k)
+{
+    if (i + 1 == matrices.size())
+    {
+        if (k > matrices[i]->nRows())
+        {
+            return true;
+        }
+        counts[i] = k;
+        return independentRows(matrices, counts);
+    }
+    for (unsigned int d = 0; d <= std::min(k, matrices[i]->nRows()); ++d)
+    {
+        counts[i] = d;
+        if (!allCompositionsIndependent(matrices, counts, i + 1, k - d))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Computes the t-value from its definition.
+unsigned int tValueFromDefinition(const std::vector<const GeneratingMatrix*>& matrices)
+{
+    const unsigned int m = matrices.front()->nCols();
+    std::vector<unsigned int> counts(matrices.size());
+    unsigned int k = m;
+    while (k > 0 && !allCompositionsIndependent(matrices, counts, 0, k))
+    {
+        --k;
+    }
+    return m - k;
+}
+
+// Returns the largest t-value of the projections obtained by removing one of the matrices.
+unsigned int maxTValueSubProj(const std::vector<const GeneratingMatrix*>& matrices)
+{
+    unsigned int res = 0;
+    for (unsigned int j = 0; j < matrices.size() && matrices.size() > 2; ++j)
+    {
+        std::vector<const GeneratingMatrix*> subProj(matrices);
+        subProj.erase(subProj.begin() + j);
+        res = std::max(res, tValueFromDefinition(subProj));
+    }
+    return res;
+}
+
+// Compares the t-values computed by the Gauss and Schmid methods with the definition.
+bool compare(const std::vector<const GeneratingMatrix*>& matrices)
+{
+    const unsigned int maxSubProj = maxTValueSubProj(matrices);
+    //! [gauss]
+    const unsigned int tGauss = GaussMethod::computeTValue(matrices, maxSubProj, 0);
+    //! [gauss]
+    const unsigned int tSchmid = SchmidMethod::computeTValue(matrices, maxSubProj, 0);
+    const unsigned int t = tValueFromDefinition(matrices);
+    return tGauss == t && tSchmid == t;
+}
+
+// Checks that the bounded Gauss method returns the t-value when it is not larger than the bound, and a value
+// larger than the bound otherwise, for all the bounds.
+bool checkBounds(const std::vector<const GeneratingMatrix*>& matrices)
+{
+    const unsigned int maxSubProj = maxTValueSubProj(matrices);
+    const unsigned int t = tValueFromDefinition(matrices);
+    for (unsigned int bound = 0; bound <= matrices.front()->nCols(); ++bound)
+    {
+        //! [bounded]
+        const unsigned int tBounded = GaussMethod::computeTValue(matrices, maxSubProj, bound, 0);
+        //! [bounded]
+        if (t <= bound ? tBounded != t : (tBounded <= bound || tBounded > t))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    SET_PATH_TO_LATNETBUILDER_FOR_EXAMPLES();
+
+    for (unsigned int m : {10, 14})
+    {
+        std::cout << "JoeKuo Sobol' nets with 2^" << m << " points" << std::endl;
+        for (Dimension s = 2; s <= 5; ++s)
+        {
+            auto net = createJoeKuoSobolNet(s, m);
+            std::vector<const GeneratingMatrix*> matrices;
+            for (Dimension j = 0; j < s; ++j)
+            {
+                matrices.push_back(&net.generatingMatrix(j));
+            }
+            std::cout << "  dimension " << s << ": "
+                << (compare(matrices) ? "Gauss, Schmid and definition agree" : "t-values DIFFER") << ", "
+                << (checkBounds(matrices) ? "bounded Gauss is consistent" : "bounded Gauss is NOT consistent") << std::endl;
+        }
+    }
+
+    std::cout << "Random nets with 2^8 points" << std::endl;
+    std::mt19937 generator(12345);
+    for (Dimension s = 2; s <= 4; ++s)
+    {
+        unsigned int agree = 0;
+        unsigned int consistent = 0;
+        const unsigned int numNets = 200;
+        for (unsigned int n = 0; n < numNets; ++n)
+        {
+            // random invertible matrices, as the t-value of one-dimensional projections is taken to be 0
+            std::vector<GeneratingMatrix> nets(s, GeneratingMatrix(8, 8));
+            std::vector<const GeneratingMatrix*> matrices;
+            for (auto& matrix : nets)
+            {
+                do
+                {
+                    for (unsigned int r = 0; r < 8; ++r)
+                    {
+                        for (unsigned int c = 0; c < 8; ++c)
+                        {
+                            matrix(r, c) = (generator() & 1);
+                        }
+                    }
+                } while (!independentRows({&matrix}, {8}));
+                matrices.push_back(&matrix);
+            }
+            agree += compare(matrices);
+            consistent += checkBounds(matrices);
+        }
+        std::cout << "  dimension " << s << ": " << agree << "/" << numNets << " nets where Gauss, Schmid and definition agree, "
+            << consistent << "/" << numNets << " where bounded Gauss is consistent" << std::endl;
+    }
+}
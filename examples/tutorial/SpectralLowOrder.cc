@@ -0,0 +1,95 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "latbuilder/ProjDepMerit/Spectral.h"
+#include "latbuilder/Types.h"
+
+#include "latticetester/Rank1Lattice.h"
+#include "latticetester/Reducer.h"
+
+#include "Path.h"
+
+#include <iostream>
+#include <cmath>
+
+using namespace LatBuilder;
+
+// square length of the shortest dual vector computed with LatticeTester
+Real shortestDualVector(uInteger numPoints, const NTL::vector<std::int64_t>& gen)
+{
+   const int order = static_cast<int>(gen.length());
+   LatticeTester::Rank1Lattice<std::int64_t, std::int64_t, Real, Real> lattice(
+         numPoints,
+         gen,
+         order,
+         LatticeTester::L2NORM);
+   lattice.buildBasis(order);
+   lattice.dualize();
+
+   LatticeTester::Reducer<std::int64_t, std::int64_t, Real, Real> reducer(lattice);
+   reducer.redDieter(0);
+   if (not reducer.shortestVector(lattice.getNorm()))
+      return 0.0;
+
+   lattice.updateVecNorm();
+   return lattice.getVecNorm(0);
+}
+
+// Compares the low-order spectral test with LatticeTester for the Korobov
+// generating vectors (1, a) and (1, a, a^2 mod n).
+void test(uInteger numPoints)
+{
+   std::cout << "number of points: " << numPoints << std::endl;
+
+   for (size_t order = 2; order <= 3; order++) {
+      size_t count = 0;
+      size_t differ = 0;
+      for (uInteger a = 1; a < numPoints; a++) {
+         NTL::vector<std::int64_t> gen(order);
+         gen(0) = 1;
+         for (size_t j = 1; j < order; j++)
+            gen(j) = static_cast<std::int64_t>(gen(j - 1) * a % numPoints);
+
+         //! [lowOrder]
+         std::int64_t g[3];
+         for (size_t j = 0; j < order; j++)
+            g[j] = gen(j);
+         const Real fast = ProjDepMerit::detail::lowOrderShortestDualVector(numPoints, g, order);
+         //! [lowOrder]
+         const Real expected = shortestDualVector(numPoints, gen);
+
+         if (expected == 0.0 or std::abs(fast - expected) > 1e-9 * expected)
+            differ++;
+         count++;
+      }
+      std::cout << "  order " << order << ": " << count << " generating vectors, ";
+      if (differ == 0)
+         std::cout << "low-order reduction and LatticeTester agree" << std::endl;
+      else
+         std::cout << differ << " DIFFER" << std::endl;
+   }
+}
+
+int main()
+{
+   SET_PATH_TO_LATNETBUILDER_FOR_EXAMPLES();
+
+   test(1021);
+   test(1024);
+   test(1000);
+
+   return 0;
+}
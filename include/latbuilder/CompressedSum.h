@@ -18,6 +18,7 @@
 #define LATBUILDER__COMPRESSED_SUM_H
 
 #include "latbuilder/Storage.h"
+#include "latbuilder/Parallel.h"
 
 namespace LatBuilder {
 
@@ -25,6 +26,7 @@ namespace LatBuilder {
  * Sum of all the elements of a (possibly compressed) vector.
  *
  * In an compressed vector some elements are implicitly repeated.
+ * The elements are added in parallel by chunks (see chunkedSum()).
  */
 template <LatticeType LR, Compress COMPRESS, PerLevelOrder PLO, class E>
 typename Storage<LR, EmbeddingType::UNILEVEL, COMPRESS, PLO>::MeritValue
@@ -35,9 +37,12 @@ compressedSum(
 {
    const auto& vec = e();
 
-   Real sum = 0.0;
-   for (const auto& x : vec)
-      sum += x;
+   Real sum = chunkedSum(vec.size(), [&vec] (size_t begin, size_t end) {
+         Real s = 0.0;
+         for (size_t i = begin; i < end; i++)
+            s += vec(i);
+         return s;
+         });
    if (LR == LatticeType::ORDINARY){
       if (COMPRESS == Compress::SYMMETRIC) {
          // compression ratio except first element
@@ -75,9 +80,12 @@ compressedSum(
 
       boost::numeric::ublas::vector_range<const E> subvec(e(), range);
 
-      double sum = 0.0;
-      for (const auto& x : subvec)
-         sum += x;
+      Real sum = chunkedSum(subvec.size(), [&subvec] (size_t begin, size_t end) {
+            Real s = 0.0;
+            for (size_t i = begin; i < end; i++)
+               s += subvec(i);
+            return s;
+            });
 
       auto level = itOut - out.begin();
 
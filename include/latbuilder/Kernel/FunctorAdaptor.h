@@ -18,6 +18,7 @@
 #define LATBUILDER__KERNEL__FUNCTOR_ADAPTOR_H
 
 #include "latbuilder/Kernel/Base.h"
+#include "latbuilder/Kernel/ValuesCache.h"
 
 #include <stdexcept>
 
@@ -60,6 +61,8 @@ public:
     *
     * \remark Checks that the functor and the compression are compatible, or
     * throws a <code>std::logic_error</code>.
+    *
+    * \remark The vector is read from the ValuesCache if it is enabled.
     */
    template <LatticeType LR, EmbeddingType L, Compress C, PerLevelOrder P >
    RealVector valuesVector(
@@ -69,18 +72,27 @@ public:
       if (storage.symmetric() and not m_functor.symmetric())
         throw std::logic_error("functor must be symmetric in order to use symmetric compression");
 
-      const auto numPoints = storage.virtualSize();
-      const auto modulus = storage.sizeParam().modulus();
+      return ValuesCache::get(name(), storage, [&] {
+         const auto numPoints = storage.virtualSize();
+         const auto modulus = storage.sizeParam().modulus();
 
-      RealVector vec(storage.size());
-      auto proxy = storage.unpermuted(vec);
+         RealVector vec(storage.size());
+         auto proxy = storage.unpermuted(vec);
 
-      for (size_t i = 0; i < vec.size(); i++)
-         proxy(i) = m_functor(Real(LatticeTraits<LR>::ToKernelIndex(i,modulus)) / numPoints, modulus);
+         for (size_t i = 0; i < vec.size(); i++)
+            proxy(i) = m_functor(Real(LatticeTraits<LR>::ToKernelIndex(i,modulus)) / numPoints, modulus);
 
-      return vec;
+         return vec;
+      });
    }
 
+   /**
+    * Returns the kernel evaluated at \c x, for a lattice of modulus \c modulus.
+    */
+   template <typename MODULUS>
+   Real pointValue(const Real& x, const MODULUS& modulus) const
+   { return m_functor(x, modulus); }
+
    /**
     * Returns \c true if the kernel takes the same value at points \f$x\f$ and
     * \f$1 - x\f$ for \f$x \in [0,1)\f$.
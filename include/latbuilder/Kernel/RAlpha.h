@@ -18,12 +18,14 @@
 #define LATBUILDER__KERNEL__R_ALPHA_H
 
 #include "latbuilder/Kernel/Base.h"
+#include "latbuilder/Kernel/ValuesCache.h"
 #include "latbuilder/Types.h"
 #include "latbuilder/fftw++.h"
 
 #include <boost/math/constants/constants.hpp>
 
 #include <sstream>
+#include <iomanip>
 #include <cmath>
 
 namespace LatBuilder { namespace Kernel {
@@ -110,28 +112,33 @@ public:
    /**
     * \copydoc Base::valuesVector()
     *
-    * Creates a new vector of kernel values using fast Fourier transforms.
+    * Creates a new vector of kernel values using fast Fourier transforms, or
+    * reads it from the ValuesCache if it is enabled.
     */
    template <LatticeType LR, EmbeddingType L, Compress C, PerLevelOrder P >
    RealVector valuesVector(
          const Storage<LR, L, C, P>& storage
          ) const
    {
-      fftw<Real>::real_vector rvec(storage.sizeParam().numPoints());
-      fftw<Real>::complex_vector cvec(storage.sizeParam().numPoints() / 2 + 1);
-      cvec[0] = 0;
-      for (size_t h = 1; h < cvec.size(); h++)
-         cvec[h] = std::pow(h, -alpha());
+      std::ostringstream key;
+      key << "R" << std::setprecision(17) << alpha();
+      return ValuesCache::get(key.str(), storage, [&] {
+         fftw<Real>::real_vector rvec(storage.sizeParam().numPoints());
+         fftw<Real>::complex_vector cvec(storage.sizeParam().numPoints() / 2 + 1);
+         cvec[0] = 0;
+         for (size_t h = 1; h < cvec.size(); h++)
+            cvec[h] = std::pow(h, -alpha());
 
-      fftw<Real>::ifft(cvec, rvec, false);
+         fftw<Real>::ifft(cvec, rvec, false);
 
-      RealVector vec(storage.size());
-      auto proxy = storage.unpermuted(vec);
+         RealVector vec(storage.size());
+         auto proxy = storage.unpermuted(vec);
 
-      for (size_t i = 0; i < vec.size(); i++)
-         proxy(i) = rvec[i];
+         for (size_t i = 0; i < vec.size(); i++)
+            proxy(i) = rvec[i];
 
-      return vec;
+         return vec;
+      });
    }
 
    /**
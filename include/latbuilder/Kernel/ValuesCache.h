@@ -0,0 +1,106 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LATBUILDER__KERNEL__VALUES_CACHE_H
+#define LATBUILDER__KERNEL__VALUES_CACHE_H
+
+#include "latbuilder/Types.h"
+#include "latbuilder/Storage.h"
+
+#include <sstream>
+#include <string>
+
+namespace LatBuilder { namespace Kernel {
+
+/**
+ * Persistent cache of vectors of kernel values.
+ *
+ * When a cache directory is set, the vectors created by the kernels are
+ * saved in that directory and later requests for the same vector, within the
+ * same run or in a later run, map the saved file instead of recomputing the
+ * kernel values.
+ *
+ * Files are named after a hash of a key that identifies the kernel with its
+ * parameters, the lattice type, the size parameter, the compression and the
+ * per-level order.  The full key is also stored in the file and checked when
+ * it is read, so that hash collisions are harmless.  A file that cannot be
+ * read or written is silently ignored and the values are computed.
+ *
+ * The cache directory is initialized from the \c LATNETBUILDER_KERNEL_CACHE
+ * environment variable and can be changed with setDirectory().  The cache is
+ * disabled when the directory is empty.
+ */
+class ValuesCache {
+public:
+   /**
+    * Sets the cache directory.  An empty string disables the cache.
+    */
+   static void setDirectory(std::string dir);
+
+   /**
+    * Returns the cache directory.
+    */
+   static const std::string& directory();
+
+   /**
+    * Returns \c true if a cache directory is set.
+    */
+   static bool enabled()
+   { return !directory().empty(); }
+
+   /**
+    * Returns the vector of kernel values identified by \c kernelKey for
+    * storage \c storage, from the cache if possible.  Otherwise, the vector is
+    * computed with \c compute() and saved to the cache.
+    *
+    * \param kernelKey  String that identifies the kernel and all its
+    *                   parameters.
+    * \param storage    Storage configuration.
+    * \param compute    Functor that returns the vector of kernel values.
+    */
+   template <LatticeType LR, EmbeddingType L, Compress C, PerLevelOrder P, class FUNC>
+   static RealVector get(const std::string& kernelKey, const Storage<LR, L, C, P>& storage, FUNC compute)
+   {
+      if (!enabled())
+         return compute();
+
+      std::ostringstream os;
+      os << kernelKey
+         << " | lattice type: " << static_cast<int>(LR)
+         << " | embedding: " << L
+         << " | storage: " << Storage<LR, L, C, P>::name()
+         << " | per-level order: " << static_cast<int>(P)
+         << " | size parameter: " << storage.sizeParam()
+         << " | size: " << storage.size();
+      const std::string key = os.str();
+
+      RealVector values;
+      if (load(key, storage.size(), values))
+         return values;
+      values = compute();
+      save(key, values);
+      return values;
+   }
+
+private:
+   static bool load(const std::string& key, size_t size, RealVector& values);
+   static void save(const std::string& key, const RealVector& values);
+   static std::string& directoryRef();
+};
+
+}}
+
+#endif
@@ -75,7 +75,8 @@ public:
    void update(const RealVector& kernelValues, typename LatticeTraits<LR>::GenValue gen);
 
    /**
-    * Computes and returns the weighted state vector \f$\boldsymbol q_s\f$.
+    * Computes the weighted state vector \f$\boldsymbol q_s\f$ into \c out,
+    * or adds it to \c out if \c accumulate is \c true.
     *
     * Computes
     * \f[
@@ -83,7 +84,9 @@ public:
     * \f]
     * where \f$e_i^{n}\f$ denotes the elementary symmetric polynomial of degree \f$i\f$ with \f$n\f$ variables. 
     */
-   RealVector weightedState() const;
+   void weightedState(RealVector& out, bool accumulate) const;
+
+   using CoordUniformState<LR, ET, COMPRESS, PLO>::weightedState;
 
     /**
     * Returns a copy of this instance.
@@ -98,7 +101,7 @@ private:
    RealVector m_elemPolySum;
    RealVector m_partialWeightedState;
    RealVector m_waitingKernelValues;
-   std::vector<RealVector> m_state;
+   std::vector<StateVector> m_state;
 };
 
 
@@ -114,7 +117,8 @@ public:
 
    void reset();
    void update(const RealVector& kernelValues, typename LatticeTraits<LR>::GenValue gen);
-   RealVector weightedState() const;
+   void weightedState(RealVector& out, bool accumulate) const;
+   using CoordUniformState<LR, ET, COMPRESS, PLO>::weightedState;
    std::unique_ptr<CoordUniformState<LR, ET, COMPRESS, PLO>> clone() const
    { return std::unique_ptr<CoordUniformState<LR, ET, COMPRESS, PLO>>(new ConcreteCoordUniformState(*this)); }
 
@@ -124,7 +128,7 @@ private:
 
    RealVector m_elemPolySum; // equals the left sum in the formula for the weighted state q
    RealVector m_partialWeightedState; // equals the right sum in the formula for the weighted state q
-   std::vector<RealVector> m_state;
+   std::vector<StateVector> m_state;
 };
 
 
@@ -140,7 +144,8 @@ public:
 
    void reset();
    void update(const RealVector& kernelValues, typename LatticeTraits<LR>::GenValue gen);
-   RealVector weightedState() const;
+   void weightedState(RealVector& out, bool accumulate) const;
+   using CoordUniformState<LR, ET, COMPRESS, PLO>::weightedState;
    std::unique_ptr<CoordUniformState<LR, ET, COMPRESS, PLO>> clone() const
    { return std::unique_ptr<CoordUniformState<LR, ET, COMPRESS, PLO>>(new ConcreteCoordUniformState(*this)); }
 
@@ -150,7 +155,7 @@ private:
 
    RealVector m_elemPolySum; // equals the left sum in the formula for the weighted state q
    RealVector m_partialWeightedState; // equals the right sum in the formula for the weighted state q
-   std::vector<RealVector> m_state;
+   std::vector<StateVector> m_state;
 };
 
 
@@ -22,6 +22,7 @@
 
 #include "latticetester/OrderDependentWeights.h"
 
+#include <limits>
 #include <vector>
 
 namespace LatBuilder { namespace MeritSeq {
@@ -29,6 +30,27 @@ namespace LatBuilder { namespace MeritSeq {
 // forward declaration
 template <LatticeType LR, EmbeddingType ET, Compress COMPRESS, PerLevelOrder PLO, class WEIGHTS> class ConcreteCoordUniformState;
 
+/**
+ * Returns the number of orders \f$\ell = 0, 1, \dots\f$ of the state vectors
+ * \f$\boldsymbol p_{s,\ell}\f$ that contribute to the weighted state for the
+ * order-dependent weights \c weights, that is, the largest order with a
+ * nonzero weight \f$\Gamma_{\ell+1}\f$, plus one.
+ *
+ * If the default weight is nonzero, all orders contribute and the largest
+ * value of \c size_t is returned.
+ */
+inline size_t numContributingOrders(const LatticeTester::OrderDependentWeights& weights)
+{
+   if (weights.getDefaultWeight() != 0.0)
+      return std::numeric_limits<size_t>::max();
+   size_t maxOrder = 1;
+   for (size_t order = 1; order <= weights.getSize(); order++) {
+      if (weights.getWeightForOrder(order) != 0.0)
+         maxOrder = order;
+   }
+   return maxOrder;
+}
+
 
 /**
  * Implementation of CoordUniformState for order-dependent weights.
@@ -100,14 +122,17 @@ public:
    void update(const RealVector& kernelValues, typename LatticeTraits<LR>::GenValue gen);
 
    /**
-    * Computes and returns the weighted state vector \f$\boldsymbol q_s\f$.
+    * Computes the weighted state vector \f$\boldsymbol q_s\f$ into \c out,
+    * or adds it to \c out if \c accumulate is \c true.
     *
     * Computes
     * \f[
     *    \boldsymbol q_s = \sum_{\ell=0}^s \Gamma_{\ell+1} \boldsymbol p_{s,\ell}.
     * \f]
     */
-   RealVector weightedState() const;
+   void weightedState(RealVector& out, bool accumulate) const;
+
+   using CoordUniformState<LR, ET, COMPRESS, PLO>::weightedState;
 
    /**
     * Returns a copy of this instance.
@@ -118,8 +143,9 @@ public:
 private:
    const LatticeTester::OrderDependentWeights& m_weights;
 
-   // m_state[level](i)
-   std::vector<RealVector> m_state;
+   // m_state[level](i), only for the levels that contribute to the weighted state
+   std::vector<StateVector> m_state;
+   size_t m_maxOrders;
 };
 
 extern template class ConcreteCoordUniformState<LatticeType::ORDINARY, EmbeddingType::UNILEVEL, Compress::NONE, PerLevelOrder::BASIC,      LatticeTester::OrderDependentWeights>;
@@ -96,14 +96,17 @@ public:
    void update(const RealVector& kernelValues, typename LatticeTraits<LR>::GenValue gen);
 
    /**
-    * Computes the weighted combination state vectors.
+    * Computes the weighted combination state vectors into \c out,
+    * or adds it to \c out if \c accumulate is \c true.
     *
     * Computes
     * \f[
     *    \boldsymbol q_s = \gamma_{s+1} \boldsymbol p_s.
     * \f]
     */
-   RealVector weightedState() const;
+   void weightedState(RealVector& out, bool accumulate) const;
+
+   using CoordUniformState<LR, ET, COMPRESS, PLO>::weightedState;
 
    /**
     * Returns a copy of this instance.
@@ -109,7 +109,8 @@ public:
    void update(const RealVector& kernelValues, typename LatticeTraits<LR>::GenValue gen);
 
    /**
-    * Computes and returns the weighted state vector \f$\boldsymbol q_s\f$.
+    * Computes the weighted state vector \f$\boldsymbol q_s\f$ into \c out,
+    * or adds it to \c out if \c accumulate is \c true.
     *
     * Computes
     * \f[
@@ -119,7 +120,9 @@ public:
     *    \, \boldsymbol p_{\mathfrak u}.
     * \f]
     */
-   RealVector weightedState() const;
+   void weightedState(RealVector& out, bool accumulate) const;
+
+   using CoordUniformState<LR, ET, COMPRESS, PLO>::weightedState;
 
     /**
     * Returns a copy of this instance.
@@ -132,7 +135,7 @@ private:
 
    // m_state[projection](i)
    // declared mutable because it is updated transparently by #getStateVector()
-   std::map<LatticeTester::Coordinates, RealVector> m_state;
+   std::map<LatticeTester::Coordinates, StateVector> m_state;
 
    // keep track of the selected generator values to be able to generate state
    // vectors on demand
@@ -144,7 +147,7 @@ private:
     *
     * \return A reference to the state vector.
     */
-   const RealVector& createStateVector(const LatticeTester::Coordinates& projection, const RealVector& kernelValues);
+   const StateVector& createStateVector(const LatticeTester::Coordinates& projection, const RealVector& kernelValues);
 };
 
 
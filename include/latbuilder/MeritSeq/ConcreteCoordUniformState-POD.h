@@ -20,6 +20,8 @@
 #include "latbuilder/MeritSeq/CoordUniformState.h"
 #include "latbuilder/Storage.h"
 
+#include "latbuilder/MeritSeq/ConcreteCoordUniformState-OD.h"
+
 #include "latticetester/PODWeights.h"
 
 #include <vector>
@@ -73,14 +75,17 @@ public:
    void update(const RealVector& kernelValues, typename LatticeTraits<LR>::GenValue gen);
 
    /**
-    * Computes and returns the weighted state vector \f$\boldsymbol q_s\f$.
+    * Computes the weighted state vector \f$\boldsymbol q_s\f$ into \c out,
+    * or adds it to \c out if \c accumulate is \c true.
     *
     * Computes
     * \f[
     *    \boldsymbol q_s = \sum_{\ell=0}^s \Gamma_{\ell+1} \boldsymbol p_{s,\ell}.
     * \f]
     */
-   RealVector weightedState() const;
+   void weightedState(RealVector& out, bool accumulate) const;
+
+   using CoordUniformState<LR, ET, COMPRESS, PLO>::weightedState;
 
       /**
     * Returns a copy of this instance.
@@ -91,8 +96,9 @@ public:
 private:
    const LatticeTester::PODWeights& m_weights;
 
-   // m_state[level](i)
-   std::vector<RealVector> m_state;
+   // m_state[level](i), only for the levels that contribute to the weighted state
+   std::vector<StateVector> m_state;
+   size_t m_maxOrders;
 };
 
 
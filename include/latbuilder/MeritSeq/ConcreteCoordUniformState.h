@@ -109,7 +109,7 @@ public:
 
       using LatticeTester::Coordinates;
 
-      auto stridedKernelValues = this->storage().strided(kernelValues, gen);
+      const RealVector& stridedKernelValues = this->stridedKernelValues(kernelValues, gen);
 
       const auto newCoordinate = this->dimension() - 1;
 
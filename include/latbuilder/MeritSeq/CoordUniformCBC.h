@@ -52,8 +52,9 @@ namespace LatBuilder { namespace MeritSeq {
  * \tparam COMPRESS     Type of compression.
  * \tparam KERNEL       Kernel of the coordinate-uniform figure of merit;
  *                      should derive from Kernel::Base.
- * \tparam PROD         Type of inner product; either CoordUniformInnerProd
- *                      or CoordUniformInnerProdFast.
+ * \tparam PROD         Type of inner product; either CoordUniformInnerProd,
+ *                      CoordUniformInnerProdFast or
+ *                      CoordUniformInnerProdFastCRT.
  */
 template <LatticeType LR, EmbeddingType ET, Compress COMPRESS, PerLevelOrder PLO,
                  class KERNEL, template <LatticeType, EmbeddingType, Compress, PerLevelOrder> class PROD = CoordUniformInnerProd >
@@ -127,14 +128,23 @@ public:
     * Returns the total weighted state.
     */
    RealVector weightedState() const
+   {
+      RealVector out;
+      weightedState(out);
+      return out;
+   }
+
+   /**
+    * Computes the total weighted state into \c out, without temporary vectors.
+    */
+   void weightedState(RealVector& out) const
    {
       auto it = states().begin();
       if (it == states().end())
          throw std::runtime_error("CoordUniformCBC: empty list of states");
-      auto out = (*it)->weightedState();
+      (*it)->weightedState(out, false);
       while (++it != states().end())
-         out += (*it)->weightedState();
-      return out;
+         (*it)->weightedState(out, true);
    }
 
    //! \copydoc CBC::baseLat()
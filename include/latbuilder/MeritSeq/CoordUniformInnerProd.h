@@ -27,6 +27,9 @@
 #include <boost/numeric/ublas/expression_types.hpp>
 #include <boost/numeric/ublas/vector_proxy.hpp>
 
+#include <memory>
+#include <stdexcept>
+
 namespace LatBuilder { namespace MeritSeq {
 
 /**
@@ -54,9 +57,28 @@ public:
          const Kernel::Base<K>& kernel
          ):
       m_storage(std::move(storage)),
-      m_kernelValues(kernel.valuesVector(this->internalStorage()))
+      m_kernelValues(std::make_shared<const RealVector>(kernel.valuesVector(this->internalStorage())))
    {}
 
+   /**
+    * Constructor with precomputed kernel values.
+    *
+    * \param storage       Storage configuration.
+    * \param kernelValues  Kernel values evaluated at every one-dimensional
+    *                      lattice point, in the order of \c storage.  They
+    *                      are shared, not copied.
+    */
+   CoordUniformInnerProd(
+         Storage<LR, ET, COMPRESS, PLO> storage,
+         std::shared_ptr<const RealVector> kernelValues
+         ):
+      m_storage(std::move(storage)),
+      m_kernelValues(std::move(kernelValues))
+   {
+      if (m_kernelValues->size() != m_storage.size())
+         throw std::logic_error("invalid size of kernel values vector");
+   }
+
    /**
     * Returns the storage configuration instance.
     */
@@ -73,7 +95,7 @@ public:
     * Returns the vector of kernel values.
     */
    const RealVector& kernelValues() const
-   { return m_kernelValues; }
+   { return *m_kernelValues; }
 
 
 public:
@@ -122,12 +144,15 @@ public:
       MeritValue element(const typename Base::const_iterator& it) const
       {
          const auto& st = m_parent.internalStorage();
+         // permuted kernel values, in a buffer reused across elements and
+         // sequences; one buffer per thread, so that element() is thread-safe
+         static thread_local RealVector strided;
+         if (strided.size() != st.size())
+            strided.resize(st.size(), false);
+         st.gatherStrided(m_parent.kernelValues(), *it, &strided[0]);
          return compressedSum(
                st,
-               boost::numeric::ublas::element_prod(
-                  m_constVec,
-                  st.strided(m_parent.m_kernelValues, *it)
-                  )
+               boost::numeric::ublas::element_prod(m_constVec, strided)
                );
       }
 
@@ -163,7 +188,8 @@ private:
 
 private:
    Storage<LR, ET, COMPRESS, PLO> m_storage;
-   RealVector m_kernelValues;
+   // shared by the copies of the instance, which do not modify it
+   std::shared_ptr<const RealVector> m_kernelValues;
 };
 
 }}
@@ -23,11 +23,13 @@
 #include "latbuilder/Storage.h"
 #include "latbuilder/CachedSeq.h"
 #include "latbuilder/IndexMap.h"
+#include "latbuilder/Parallel.h"
 #include "latbuilder/fftw++.h"
 
 #include <boost/numeric/ublas/expression_types.hpp>
 #include <boost/numeric/ublas/vector_proxy.hpp>
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -49,6 +51,14 @@ namespace detail {
  *
  * Implemented for integer powers of prime bases, as proposed in \cite rCOO06a .
  *
+ * On each level, the matrix of permuted kernel values consists of a single
+ * circulant block, except in base 2 without symmetric compression, where the
+ * group of units is the union of two cyclic cosets.  In that case, each level
+ * consists of two circulant half-blocks: the generators in the first half of
+ * the sequence map each half-block onto itself, and those in the second half
+ * swap the two half-blocks.  The product is then computed from the transforms
+ * of both halves of the vector and of the kernel values.
+ *
  * Computes the inner product with a second vector for all vectors in the
  * sequence at once.
  */
@@ -58,6 +68,7 @@ class CoordUniformInnerProdFast {
 protected:
    typedef typename fftw<Real>::real_vector FFTRealVector;
    typedef typename fftw<Real>::complex_vector FFTComplexVector;
+   typedef typename fftw<Real>::inplace_transform FFTWorkspace;
 
 public:
    typedef Storage<LR, EmbeddingType::MULTILEVEL, COMPRESS, PerLevelOrder::CYCLIC> InternalStorage;
@@ -81,7 +92,9 @@ public:
       m_internalStorage(asIntenalStorage(this->storage())),
       m_kernelValues(kernel.valuesVector(this->internalStorage())),
       m_levelRanges(cacheLevelRanges()),
-      m_circulantFFT(computeCirculantFFT())
+      m_blockRanges(cacheBlockRanges()),
+      m_circulantFFT(computeCirculantFFT()),
+      m_workspace(createWorkspace())
    {}
 
    /**
@@ -108,13 +121,42 @@ public:
    const std::vector<boost::numeric::ublas::range>& levelRanges() const
    { return m_levelRanges; }
 
+   /**
+    * Returns the vector of ranges of indices of the circulant blocks, level by
+    * level.
+    */
+   const std::vector<boost::numeric::ublas::range>& blockRanges() const
+   { return m_blockRanges; }
+
+   /**
+    * Returns the number of circulant blocks on level \c level.
+    */
+   size_t blockCount(size_t level) const
+   { return m_firstBlock[level + 1] - m_firstBlock[level]; }
+
    /**
     * Returns the FFT's of the first column of each circulant submatrix in the
-    * horizontal block-circulant matrix.
+    * horizontal block-circulant matrix, in the same order as blockRanges().
     */
    const std::vector<FFTComplexVector>& circulantFFT() const
    { return m_circulantFFT; }
 
+   /**
+    * Returns the index, relative to the start of level \c level, at which the
+    * product for the generator at index \c row in the generator sequence is
+    * stored.
+    */
+   size_t levelIndex(size_t level, size_t row) const
+   {
+      const auto size = levelRanges()[level].size();
+      if (blockCount(level) == 1)
+         return row % size;
+      // products for the generators that swap the half-blocks are stored in
+      // the second half of the level
+      const bool swap = row >= levelRanges().back().size() / 2;
+      return (swap ? size / 2 : 0) + row % (size / 2);
+   }
+
 
 private:
    std::vector<boost::numeric::ublas::range> cacheLevelRanges() const
@@ -125,77 +167,172 @@ private:
       return out;
    }
 
+   /**
+    * Splits each level into circulant blocks and sets the index of the first
+    * block of each level.
+    */
+   std::vector<boost::numeric::ublas::range> cacheBlockRanges()
+   {
+      // in base 2, on each level, we have 2 circulant half-blocks instead of
+      // a single circulant block
+      const bool halfBlocks =
+         LR == LatticeType::ORDINARY and
+         not internalStorage().symmetric() and
+         internalStorage().sizeParam().base() == 2;
+
+      std::vector<boost::numeric::ublas::range> out;
+      m_firstBlock.clear();
+      for (const auto& range : levelRanges()) {
+         m_firstBlock.push_back(out.size());
+         if (halfBlocks and range.size() >= 2) {
+            const auto half = range.size() / 2;
+            out.emplace_back(range.start(), range.start() + half);
+            out.emplace_back(range.start() + half, range.start() + range.size());
+         }
+         else
+            out.push_back(range);
+      }
+      m_firstBlock.push_back(out.size());
+      return out;
+   }
+
    template <class E>
    RealVector computeProdValues(
          const boost::numeric::ublas::vector_expression<E>& ve
          ) const
    {
-      if(LR == LatticeType::ORDINARY){
-        // in base 2, on each level, we have 2 circulant half-blocks instead of
-        // a single circulant block
-        if (not internalStorage().symmetric() and internalStorage().sizeParam().base() == 2)
-           throw std::logic_error("not implemented for non-symmetric vectors in base 2");
-       }
+      RealVector out(ve().size());
+      computeProdValues(ve, out);
+      return out;
+   }
 
+   /**
+    * Computes the inner products of \c ve with all the permutations of the
+    * kernel values and stores them into \c out.
+    *
+    * The per-level transforms are performed in place in the preallocated
+    * workspace; no memory is allocated.  The highest level, which holds about
+    * as many elements as all other levels together, is transformed first with
+    * a multithreaded plan when it is large enough; the other levels are then
+    * transformed concurrently.  Because the workspace is shared by all calls,
+    * this function must not be called concurrently on the same instance.
+    */
+   template <class E>
+   void computeProdValues(
+         const boost::numeric::ublas::vector_expression<E>& ve,
+         RealVector& out
+         ) const
+   {
       const auto& vec = ve();
-      using namespace boost::numeric::ublas;
-
-      auto itRange = levelRanges().begin();
-      auto itRangePrev = itRange;
-      auto itCirculantFFT = circulantFFT().begin();
 
-      RealVector out(vec.size());
-
-      while (itRange != levelRanges().end()) {
-
-         if (itCirculantFFT == circulantFFT().end())
-            throw std::logic_error("circulant FFT's have too few levels");
-
-         // select vector range
-         vector_range<const RealVector> subvec(vec, *itRange);
-
-         // convert to FFT-compatible vectors
-         FFTRealVector rvec(subvec.begin(), subvec.end());
-
-         // compute FFT
-         FFTComplexVector cvec = fftw<Real>::fft(rvec);
-
-         // ratio of the number or natural elements to the number of internal
-         // elements, multiplied by normalization
-         size_t compressionRatio = 1;
-         if(LR == LatticeType::ORDINARY){
-           if (internalStorage().symmetric() and (itRange - levelRanges().begin()) >= (internalStorage().sizeParam().base() == 2 ? 2 : 1)) {
-              // compressionRatio except if uncompressed level has only one element
-              compressionRatio = 2;
-           }
+      if (circulantFFT().size() < blockRanges().size())
+         throw std::logic_error("circulant FFT's have too few blocks");
+
+      if (out.size() != vec.size())
+         out.resize(vec.size(), false);
+
+      const long numLevels = static_cast<long>(levelRanges().size());
+
+      if (numLevels > 0)
+         convolveLevel(vec, numLevels - 1, out);
+
+      #pragma omp parallel for schedule(dynamic, 1)
+      for (long level = numLevels - 2; level >= 0; level--)
+         convolveLevel(vec, level, out);
+
+      // add contributions from lower levels
+      for (long level = 1; level < numLevels; level++) {
+         const auto& range = levelRanges()[level];
+         const auto& prevRange = levelRanges()[level - 1];
+         Real* curLevel = &out[range.start()];
+         const Real* prevLevel = &out[prevRange.start()];
+         const long size = static_cast<long>(range.size());
+         const long prevSize = static_cast<long>(prevRange.size());
+         if (blockCount(level - 1) == 1) {
+            #pragma omp parallel for if(range.size() >= MinParallelSize)
+            for (long i = 0; i < size; i++)
+               curLevel[i] += prevLevel[i % prevSize];
          }
+         else {
+            // the swapping generators are stored in the second half-block of
+            // both levels
+            const long half = size / 2;
+            const long prevHalf = prevSize / 2;
+            #pragma omp parallel for if(range.size() >= MinParallelSize)
+            for (long i = 0; i < size; i++)
+               curLevel[i] += prevLevel[(i < half ? 0 : prevHalf) + i % prevHalf];
+         }
+      }
+   }
 
-         // multiply in Fourier space
-         for (size_t i = 0; i < cvec.size(); i++)
-            cvec[i] *= compressionRatio * (*itCirculantFFT)[i];
+   /**
+    * Computes the circulant product on level \c level and stores the result
+    * into the corresponding range of \c out, without the contributions from
+    * lower levels.
+    */
+   template <class E>
+   void convolveLevel(const E& vec, long level, RealVector& out) const
+   {
+      using namespace boost::numeric::ublas;
 
-         // inverse transform
-         fftw<Real>::ifft(cvec, rvec, true);
+      const size_t first = m_firstBlock[level];
+      const size_t last = m_firstBlock[level + 1];
 
-         // export to the output vector
-         std::copy(rvec.begin(), rvec.end(), &out[itRange->start()]);
+      // load the vector blocks into the transform buffers and compute FFT's
+      for (size_t block = first; block < last; block++) {
+         auto& work = m_workspace[block];
+         vector_range<const E> subvec(vec, blockRanges()[block]);
+         std::copy(subvec.begin(), subvec.end(), work.real_data());
+         work.forward();
+      }
 
-         // add contributions from lower levels
-         if (itRange != itRangePrev) {
-            typedef typename vector_range<RealVector>::size_type size_type;
-            vector_range<RealVector> curLevel(out, *itRange);
-            vector_range<const RealVector> prevLevel(out, *itRangePrev);
-            for (size_type i = 0; i < curLevel.size(); i++)
-               curLevel[i] += prevLevel[i % prevLevel.size()];
+      // ratio of the number or natural elements to the number of internal
+      // elements, multiplied by normalization
+      size_t compressionRatio = 1;
+      if(LR == LatticeType::ORDINARY){
+        if (internalStorage().symmetric() and level >= (internalStorage().sizeParam().base() == 2 ? 2 : 1)) {
+           // compressionRatio except if uncompressed level has only one element
+           compressionRatio = 2;
+        }
+      }
+      const Real scale = Real(compressionRatio) / blockRanges()[first].size();
+
+      // multiply in Fourier space
+      if (last - first == 1) {
+         const auto& circulant = circulantFFT()[first];
+         auto& work = m_workspace[first];
+         auto cvec = work.complex_data();
+         const long csize = static_cast<long>(work.complex_size());
+         #pragma omp parallel for if(work.threads() > 1)
+         for (long i = 0; i < csize; i++)
+            cvec[i] *= scale * circulant[i];
+      }
+      else {
+         // the first half of the output is the product with the diagonal
+         // half-blocks, the second half is the product with the swapped ones
+         const auto& circulantA = circulantFFT()[first];
+         const auto& circulantB = circulantFFT()[first + 1];
+         auto& workA = m_workspace[first];
+         auto& workB = m_workspace[first + 1];
+         auto cvecA = workA.complex_data();
+         auto cvecB = workB.complex_data();
+         const long csize = static_cast<long>(workA.complex_size());
+         #pragma omp parallel for if(workA.threads() > 1)
+         for (long i = 0; i < csize; i++) {
+            const auto a = cvecA[i];
+            const auto b = cvecB[i];
+            cvecA[i] = scale * (a * circulantA[i] + b * circulantB[i]);
+            cvecB[i] = scale * (a * circulantB[i] + b * circulantA[i]);
          }
-
-         itRangePrev = itRange;
-
-         ++itCirculantFFT;
-         ++itRange;
       }
 
-      return out;
+      // inverse transforms and export to the output vector
+      for (size_t block = first; block < last; block++) {
+         auto& work = m_workspace[block];
+         const auto& range = blockRanges()[block];
+         work.backward();
+         std::copy(work.real_data(), work.real_data() + range.size(), &out[range.start()]);
+      }
    }
 
 public:
@@ -249,15 +386,10 @@ public:
 
       MeritValue element(const typename Base::const_iterator& it) const
       {
+         const size_t row = it - it.seq().begin();
          RealVector mlMerit(m_parent.levelRanges().size());
-         for (
-               auto itRange = m_parent.levelRanges().begin();
-               itRange != m_parent.levelRanges().end();
-               ++itRange
-               ) {
-            boost::numeric::ublas::vector_range<const RealVector> curLevel(m_values, *itRange);
-            mlMerit[itRange - m_parent.levelRanges().begin()] = curLevel[(it - it.seq().begin()) % curLevel.size()];
-         }
+         for (size_t level = 0; level < m_parent.levelRanges().size(); level++)
+            mlMerit[level] = m_values[m_parent.levelRanges()[level].start() + m_parent.levelIndex(level, row)];
 
          MeritValue merit = m_parent.storage().createMeritValue(0.0);
          return storeMeritValue(merit, std::move(mlMerit));
@@ -298,7 +430,7 @@ private:
     */
    std::vector<FFTComplexVector> computeCirculantFFT() const
    {
-      const auto ranges = levelRanges();
+      const auto ranges = blockRanges();
 
       std::vector<FFTComplexVector> result(ranges.size());
 
@@ -308,7 +440,7 @@ private:
             ++itRange
             ) {
 
-         // select level
+         // select block
          boost::numeric::ublas::vector_range<const RealVector> lvec(
                kernelValues(),
                *itRange
@@ -328,6 +460,27 @@ private:
       return result;
    }
 
+   /**
+    * Minimum size of the highest level for its transforms to be split across
+    * threads.
+    */
+   static constexpr size_t MinThreadedFFTSize = 1 << 16;
+
+   /**
+    * Allocates the in-place transform buffers and plans for each block.
+    */
+   std::vector<FFTWorkspace> createWorkspace() const
+   {
+      std::vector<FFTWorkspace> result;
+      result.reserve(blockRanges().size());
+      for (const auto& range : blockRanges()) {
+         // only the highest level is transformed outside of a parallel region
+         const bool highest = result.size() >= m_firstBlock[levelRanges().size() - 1];
+         result.emplace_back(range.size(), highest and range.size() >= MinThreadedFFTSize and !inParallel() ? maxThreads() : 1);
+      }
+      return result;
+   }
+
    InternalStorage asIntenalStorage(const InternalStorage& s)
    { return s; }
 
@@ -364,7 +517,10 @@ private:
    InternalStorage m_internalStorage;
    RealVector m_kernelValues;
    std::vector<boost::numeric::ublas::range> m_levelRanges;
+   std::vector<size_t> m_firstBlock;
+   std::vector<boost::numeric::ublas::range> m_blockRanges;
    std::vector<FFTComplexVector> m_circulantFFT;
+   mutable std::vector<FFTWorkspace> m_workspace;
 };
 
 
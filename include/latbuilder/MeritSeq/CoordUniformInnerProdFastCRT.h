@@ -0,0 +1,542 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LATBUILDER__MERIT_SEQ__INNER_PROD_FAST_CRT_H
+#define LATBUILDER__MERIT_SEQ__INNER_PROD_FAST_CRT_H
+
+#include "latbuilder/MeritSeq/CoordUniformStateCreator.h"
+#include "latbuilder/BridgeSeq.h"
+#include "latbuilder/BridgeIteratorCached.h"
+#include "latbuilder/Storage.h"
+#include "latbuilder/CompressTraits.h"
+#include "latbuilder/Parallel.h"
+#include "latbuilder/Util.h"
+#include "latbuilder/fftw++.h"
+
+#include <boost/numeric/ublas/vector_proxy.hpp>
+
+#include <algorithm>
+#include <complex>
+#include <map>
+#include <vector>
+
+namespace LatBuilder { namespace MeritSeq {
+
+/**
+ * FFT-based implementation of the inner product for a sequence of vector with
+ * a single vector, for ordinary lattices with an arbitrary number of points.
+ *
+ * Let \f$n\f$ be the number of points, and let \f$V_i\f$ and \f$Q_i\f$ denote
+ * the kernel value and the component of the second vector at the natural
+ * (uncompressed) index \f$i\f$.  The inner product for the generator \f$a\f$
+ * is \f$\sum_{i=0}^{n-1} Q_i V_{a i \bmod n}\f$.  By writing \f$i = d j\f$ with
+ * \f$d = \gcd(i, n)\f$ and \f$j \in \mathbb Z_m^*\f$ where \f$m = n / d\f$, it
+ * becomes a sum, over the divisors \f$m\f$ of \f$n\f$, of correlations on the
+ * groups of units \f$\mathbb Z_m^*\f$.
+ *
+ * By the Chinese remainder theorem, each \f$\mathbb Z_m^*\f$ is a direct
+ * product of cyclic groups: one generated by a primitive root for each odd
+ * prime power in \f$m\f$, plus the groups generated by \f$-1\f$ and \f$5\f$ for
+ * the power of 2 in \f$m\f$.  Every correlation is thus a multidimensional
+ * cyclic correlation in discrete logarithm coordinates, computed with a
+ * multidimensional FFT.  The generators are chosen such that the coordinates
+ * of \f$a \bmod m\f$ are those of \f$a\f$ reduced modulo the orders on
+ * \f$\mathbb Z_m^*\f$, so the correlations are accumulated onto \f$\mathbb
+ * Z_n^*\f$ one prime factor at a time, as the lower levels are in
+ * CoordUniformInnerProdFast.
+ *
+ * The number of operations is \f$O(n \log n)\f$ for all generators at once.
+ * When \f$n\f$ is a prime power, this is the construction of \cite rCOO06a
+ * with natural indices.
+ *
+ * Only ordinary lattices with unilevel storage are supported.
+ */
+template <LatticeType LR, EmbeddingType ET, Compress COMPRESS, PerLevelOrder PLO>
+class CoordUniformInnerProdFastCRT {
+
+   static_assert(LR == LatticeType::ORDINARY and ET == EmbeddingType::UNILEVEL,
+         "CRT-based fast product is implemented only for unilevel ordinary lattices");
+
+protected:
+   typedef typename fftw<Real>::complex_vector FFTComplexVector;
+   typedef typename fftw<Real>::multi_transform FFTWorkspace;
+   typedef CompressTraits<COMPRESS> Compression;
+   typedef typename LatticeTraits<LR>::Modulus Modulus;
+
+public:
+   typedef Storage<LR, ET, COMPRESS, PLO> InternalStorage;
+   typedef CoordUniformStateList<LR, ET, COMPRESS, PLO> StateList;
+   typedef typename Storage<LR, ET, COMPRESS, PLO>::MeritValue MeritValue;
+
+   /**
+    * Constructor.
+    *
+    * \param storage       Storage configuration.
+    * \param kernel        Kernel.  Used to create a sequence of
+    *                      permuatations of the kernel values evaluated at every
+    *                      one-dimensional lattice point.
+    */
+   template <class K>
+   CoordUniformInnerProdFastCRT(
+         Storage<LR, ET, COMPRESS, PLO> storage,
+         const Kernel::Base<K>& kernel
+         ):
+      m_storage(std::move(storage)),
+      m_kernelValues(kernel.valuesVector(this->internalStorage())),
+      m_modulus(this->storage().sizeParam().modulus())
+   {
+      initAxes();
+      initDivisors();
+      m_workspace = createWorkspace();
+      computeKernelFFT();
+   }
+
+   /**
+    * Returns the storage configuration instance.
+    */
+   const Storage<LR, ET, COMPRESS, PLO>& storage() const
+   { return m_storage; }
+
+   /**
+    * Returns the internal storage configuration instance.
+    */
+   const InternalStorage& internalStorage() const
+   { return m_storage; }
+
+   /**
+    * Returns the vector of kernel values.
+    */
+   const RealVector& kernelValues() const
+   { return m_kernelValues; }
+
+   /**
+    * Returns the number of divisors of the number of points.
+    */
+   size_t divisorCount() const
+   { return m_divisors.size(); }
+
+   /**
+    * Returns the range of indices of the products on the group of units
+    * modulo the \c k-th smallest divisor of the number of points.
+    */
+   const boost::numeric::ublas::range& divisorRange(size_t k) const
+   { return m_divisors[k].range; }
+
+   /**
+    * Returns the index, relative to the start of the highest divisor range, at
+    * which the product for generator \c gen is stored.
+    */
+   size_t position(typename LatticeTraits<LR>::GenValue gen) const
+   { return m_position[Compression::compressIndex(gen % m_modulus, m_modulus)]; }
+
+private:
+   /// Cyclic factor of the groups of units.
+   struct Axis {
+      /// Prime factor of the modulus.
+      Modulus prime;
+      /// Index of the prime factor.
+      size_t primeIndex;
+      /// Generator lifted to the units modulo the number of points.
+      Modulus generator;
+      /// Smallest exponent of \c prime from which the generator has order
+      /// larger than 1.
+      unsigned int minPower;
+   };
+
+   /// Correlation on the group of units modulo a divisor of the modulus.
+   struct Divisor {
+      /// Divisor of the number of points.
+      Modulus modulus;
+      /// Order of the generator of each axis.
+      std::vector<size_t> shape;
+      /// Index of the divisor \c modulus / p for each prime factor p, or -1.
+      std::vector<long> lower;
+      /// Storage indices of the natural indices (n / modulus) j, for all
+      /// units j in row-major order of the discrete logarithms.
+      std::vector<size_t> gather;
+      /// Range of indices in the vector of products.
+      boost::numeric::ublas::range range;
+      /// FFT of the kernel values in the same order as \c gather.
+      FFTComplexVector kernelFFT;
+   };
+
+   /**
+    * Returns the order of the generator of \c axis modulo \c prime raised to
+    * \c power.
+    */
+   static size_t axisOrder(const Axis& axis, unsigned int power)
+   {
+      if (power < axis.minPower)
+         return 1;
+      if (axis.prime != 2)
+         return intPow(axis.prime, power - 1) * (axis.prime - 1);
+      // -1 has order 2, 5 has order 2^(power - 2)
+      return axis.minPower == 2 ? 2 : intPow(Modulus(2), power - 2);
+   }
+
+   /**
+    * Returns a primitive root modulo \c prime raised to \c power, for an odd
+    * prime.
+    */
+   static Modulus primitiveRoot(Modulus prime, unsigned int power)
+   {
+      const auto factors = primeFactors(prime - 1);
+      Modulus g = 2;
+      while (std::any_of(factors.begin(), factors.end(),
+               [&] (uInteger f) { return modularPow(g, (prime - 1) / f, prime) == 1; }))
+         g++;
+      // a primitive root modulo p^2 is a primitive root modulo all powers of p
+      if (power >= 2 and modularPow(g, prime - 1, prime * prime) == 1)
+         g += prime;
+      return g;
+   }
+
+   /**
+    * Selects the generators of the cyclic factors of the group of units.
+    */
+   void initAxes()
+   {
+      m_primes.clear();
+      m_powers.clear();
+      m_axes.clear();
+      for (const auto& f : primeFactorsMap(m_modulus)) {
+         const Modulus prime = f.first;
+         const unsigned int power = static_cast<unsigned int>(f.second);
+         const Modulus primePower = intPow(prime, power);
+         const Modulus cofactor = m_modulus / primePower;
+
+         // unit that is 1 modulo primePower and 0 modulo cofactor
+         long long inverse = egcd(primePower, cofactor).second % static_cast<long long>(primePower);
+         if (inverse < 0)
+            inverse += primePower;
+         const Modulus e = mulMod(cofactor, Modulus(inverse), m_modulus);
+         const auto lift = [&] (Modulus g) {
+            // g modulo primePower and 1 modulo cofactor
+            return (1 + mulMod((g % primePower + m_modulus - 1) % m_modulus, e, m_modulus)) % m_modulus;
+         };
+
+         const size_t primeIndex = m_primes.size();
+         m_primes.push_back(prime);
+         m_powers.push_back(power);
+         if (prime != 2)
+            m_axes.push_back(Axis{prime, primeIndex, lift(primitiveRoot(prime, power)), 1});
+         else {
+            if (power >= 2)
+               m_axes.push_back(Axis{prime, primeIndex, lift(primePower - 1), 2});
+            if (power >= 3)
+               m_axes.push_back(Axis{prime, primeIndex, lift(5), 3});
+         }
+      }
+   }
+
+   /**
+    * Enumerates the divisors of the modulus in increasing order, together
+    * with the discrete logarithm coordinates of their groups of units.
+    */
+   void initDivisors()
+   {
+      // all combinations of powers of the prime factors
+      std::vector<std::vector<unsigned int>> exponents(1, std::vector<unsigned int>(m_primes.size(), 0));
+      for (size_t k = 0; k < m_primes.size(); k++) {
+         const size_t count = exponents.size();
+         for (unsigned int p = 1; p <= m_powers[k]; p++) {
+            for (size_t i = 0; i < count; i++) {
+               auto exps = exponents[i];
+               exps[k] = p;
+               exponents.push_back(std::move(exps));
+            }
+         }
+      }
+
+      std::map<Modulus, std::vector<unsigned int>> sorted;
+      for (const auto& exps : exponents) {
+         Modulus m = 1;
+         for (size_t k = 0; k < m_primes.size(); k++)
+            m *= intPow(m_primes[k], exps[k]);
+         sorted[m] = exps;
+      }
+
+      std::map<Modulus, long> index;
+      m_divisors.clear();
+      m_divisors.reserve(sorted.size());
+      size_t start = 0;
+      for (const auto& entry : sorted) {
+         const Modulus m = entry.first;
+         const auto& exps = entry.second;
+         Divisor div;
+         div.modulus = m;
+
+         size_t size = 1;
+         for (const auto& axis : m_axes) {
+            div.shape.push_back(axisOrder(axis, exps[axis.primeIndex]));
+            size *= div.shape.back();
+         }
+
+         for (size_t k = 0; k < m_primes.size(); k++)
+            div.lower.push_back(exps[k] == 0 ? -1 : index[m / m_primes[k]]);
+
+         // powers of the generators modulo m
+         std::vector<std::vector<Modulus>> powers(m_axes.size());
+         for (size_t a = 0; a < m_axes.size(); a++) {
+            powers[a].resize(div.shape[a]);
+            Modulus x = 1 % m;
+            for (auto& p : powers[a]) {
+               p = x;
+               x = x * (m_axes[a].generator % m) % m;
+            }
+         }
+
+         const Modulus d = m_modulus / m;
+         div.gather.resize(size);
+         for (size_t pos = 0; pos < size; pos++) {
+            Modulus unit = 1 % m;
+            size_t rem = pos;
+            for (size_t a = m_axes.size(); a-- > 0;) {
+               unit = unit * powers[a][rem % div.shape[a]] % m;
+               rem /= div.shape[a];
+            }
+            div.gather[pos] = Compression::compressIndex(d * unit, m_modulus);
+         }
+
+         div.range = boost::numeric::ublas::range(start, start + size);
+         start += size;
+         index[m] = static_cast<long>(m_divisors.size());
+         m_divisors.push_back(std::move(div));
+      }
+
+      // with d = 1, the storage index of each unit maps to its position
+      const auto& top = m_divisors.back();
+      m_position.assign(Compression::size(m_modulus), 0);
+      for (size_t pos = 0; pos < top.gather.size(); pos++)
+         m_position[top.gather[pos]] = pos;
+   }
+
+   /**
+    * Minimum size of the group of units modulo the number of points for its
+    * transforms to be split across threads.
+    */
+   static constexpr size_t MinThreadedFFTSize = 1 << 16;
+
+   /**
+    * Allocates the transform buffers and plans for each divisor.
+    */
+   std::vector<FFTWorkspace> createWorkspace() const
+   {
+      std::vector<FFTWorkspace> result;
+      result.reserve(m_divisors.size());
+      for (const auto& div : m_divisors) {
+         // dimensions of size 1 are dropped
+         std::vector<int> shape;
+         for (const auto s : div.shape)
+            if (s > 1)
+               shape.push_back(static_cast<int>(s));
+         if (shape.empty())
+            shape.push_back(1);
+         // only the highest divisor is transformed outside of a parallel region
+         const bool highest = result.size() + 1 == m_divisors.size();
+         result.emplace_back(std::move(shape), highest and div.range.size() >= MinThreadedFFTSize and !inParallel() ? maxThreads() : 1);
+      }
+      return result;
+   }
+
+   /**
+    * Computes the FFT's of the kernel values on each group of units.
+    */
+   void computeKernelFFT()
+   {
+      for (size_t k = 0; k < m_divisors.size(); k++) {
+         auto& div = m_divisors[k];
+         auto& work = m_workspace[k];
+         Real* data = work.real_data();
+         for (size_t pos = 0; pos < div.gather.size(); pos++)
+            data[pos] = m_kernelValues[div.gather[pos]];
+         work.forward();
+         div.kernelFFT.assign(work.complex_data(), work.complex_data() + work.complex_size());
+      }
+   }
+
+   /**
+    * Computes the inner products of \c ve with all the permutations of the
+    * kernel values, in the order of the discrete logarithm coordinates.
+    *
+    * The correlation on the group of units modulo the number of points is
+    * computed first, with a multithreaded plan when it is large enough; the
+    * other divisors are then processed concurrently.  Because the workspace
+    * is shared by all calls, this function must not be called concurrently on
+    * the same instance.
+    */
+   template <class E>
+   RealVector computeProdValues(
+         const boost::numeric::ublas::vector_expression<E>& ve
+         ) const
+   {
+      const auto& vec = ve();
+
+      if (vec.size() != internalStorage().size())
+         throw std::logic_error("invalid size of weighted state vector");
+
+      const auto& top = m_divisors.back().range;
+      RealVector out(top.start() + top.size());
+
+      const long numDivisors = static_cast<long>(m_divisors.size());
+
+      correlate(vec, numDivisors - 1, out);
+
+      #pragma omp parallel for schedule(dynamic, 1)
+      for (long k = numDivisors - 2; k >= 0; k--)
+         correlate(vec, k, out);
+
+      // add the contributions from the lower divisors, one prime at a time
+      for (size_t p = 0; p < m_primes.size(); p++) {
+         for (const auto& div : m_divisors) {
+            if (div.lower[p] < 0)
+               continue;
+            const auto& low = m_divisors[div.lower[p]];
+            Real* cur = &out[div.range.start()];
+            const Real* prev = &out[low.range.start()];
+            const long size = static_cast<long>(div.range.size());
+            #pragma omp parallel for if(div.range.size() >= MinParallelSize)
+            for (long pos = 0; pos < size; pos++) {
+               size_t rem = static_cast<size_t>(pos);
+               size_t src = 0;
+               size_t stride = 1;
+               for (size_t a = div.shape.size(); a-- > 0;) {
+                  src += (rem % div.shape[a]) % low.shape[a] * stride;
+                  rem /= div.shape[a];
+                  stride *= low.shape[a];
+               }
+               cur[pos] += prev[src];
+            }
+         }
+      }
+
+      return out;
+   }
+
+   /**
+    * Computes the correlation of \c vec with the kernel values on the group
+    * of units modulo the \c k-th divisor and stores the result into the
+    * corresponding range of \c out.
+    */
+   template <class E>
+   void correlate(const E& vec, long k, RealVector& out) const
+   {
+      const auto& div = m_divisors[k];
+      auto& work = m_workspace[k];
+
+      Real* data = work.real_data();
+      const long size = static_cast<long>(div.gather.size());
+      for (long pos = 0; pos < size; pos++)
+         data[pos] = vec(div.gather[pos]);
+      work.forward();
+
+      const Real scale = Real(1) / size;
+      auto cvec = work.complex_data();
+      const long csize = static_cast<long>(work.complex_size());
+      #pragma omp parallel for if(work.threads() > 1)
+      for (long i = 0; i < csize; i++)
+         cvec[i] = scale * std::conj(cvec[i]) * div.kernelFFT[i];
+
+      work.backward();
+      std::copy(data, data + size, &out[div.range.start()]);
+   }
+
+public:
+   /**
+    * Sequence of inner product values.
+    *
+    * \tparam GENSEQ    Type of sequence of generator values.  All generator
+    *                   values must be coprime with the number of points.
+    */
+   template <class GENSEQ>
+   class Seq :
+      public BridgeSeq<
+         Seq<GENSEQ>,                           // self type
+         GENSEQ,                                // base type
+         MeritValue,                            // value type
+         BridgeIteratorCached> {
+
+   public:
+
+      typedef GENSEQ GenSeq;
+      typedef typename Seq::Base Base;
+      typedef typename Seq::size_type size_type;
+
+      /**
+       * Constructor.
+       *
+       * \param parent     Parent inner product instance.
+       * \param genSeq     Sequence of generator sequences that determines the
+       *                   order of the permutations of \c baseVec.
+       * \param vec        Second operand in the inner product.
+       */
+      template <class E>
+      Seq(
+            const CoordUniformInnerProdFastCRT& parent,
+            GenSeq genSeq,
+            const boost::numeric::ublas::vector_expression<E>& vec
+            ):
+         Seq::BridgeSeq_(std::move(genSeq)),
+         m_parent(parent),
+         m_values(parent.computeProdValues(vec())),
+         m_offset(parent.m_divisors.back().range.start())
+      {}
+
+      /**
+       * Returns the parent inner product of this sequence.
+       */
+      const CoordUniformInnerProdFastCRT& innerProd() const
+      { return m_parent; }
+
+      MeritValue element(const typename Base::const_iterator& it) const
+      { return m_parent.storage().createMeritValue(m_values[m_offset + m_parent.position(*it)]); }
+
+   private:
+      const CoordUniformInnerProdFastCRT& m_parent;
+      RealVector m_values;
+      size_t m_offset;
+   };
+
+   /**
+    * Creates a new sequence of inner product values by applying a stride
+    * permutation based on \c genSeq to the vector of kernel values, then by
+    * computing the inner product with \c vec.
+    *
+    * \param genSeq     Sequence of generator values.
+    * \param vec        Second operand in the inner product.
+    */
+   template <class GENSEQ, class E>
+   Seq<GENSEQ> prodSeq(
+         const GENSEQ& genSeq,
+         const boost::numeric::ublas::vector_expression<E>& vec
+         ) const
+   { return Seq<GENSEQ>(*this, genSeq, vec); }
+
+private:
+   Storage<LR, ET, COMPRESS, PLO> m_storage;
+   RealVector m_kernelValues;
+   Modulus m_modulus;
+   std::vector<Modulus> m_primes;
+   std::vector<unsigned int> m_powers;
+   std::vector<Axis> m_axes;
+   std::vector<Divisor> m_divisors;
+   std::vector<size_t> m_position;
+   mutable std::vector<FFTWorkspace> m_workspace;
+};
+
+}}
+
+#endif
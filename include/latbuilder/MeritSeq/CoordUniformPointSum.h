@@ -0,0 +1,326 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LATBUILDER__MERIT_SEQ__COORD_UNIFORM_POINT_SUM_H
+#define LATBUILDER__MERIT_SEQ__COORD_UNIFORM_POINT_SUM_H
+
+#include "latbuilder/CoordUniformFigureOfMerit.h"
+#include "latbuilder/Kernel/FunctorAdaptor.h"
+#include "latbuilder/MeritSeq/ConcreteCoordUniformState-OD.h"
+#include "latbuilder/BridgeSeq.h"
+#include "latbuilder/BridgeIteratorCached.h"
+#include "latbuilder/LatDef.h"
+#include "latbuilder/Parallel.h"
+#include "latbuilder/Storage.h"
+#include "latbuilder/Util.h"
+
+#include "latticetester/OrderDependentWeights.h"
+#include "latticetester/PODWeights.h"
+#include "latticetester/ProductWeights.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace LatBuilder { namespace MeritSeq {
+
+/**
+ * Whether the kernel \c KERNEL can be evaluated at a single point in constant
+ * time, which is the case of the kernels derived from Kernel::FunctorAdaptor.
+ */
+template <class KERNEL, class = void>
+struct HasPointValue : std::false_type {};
+
+template <class KERNEL>
+struct HasPointValue<KERNEL, typename std::enable_if<
+   std::is_base_of<Kernel::FunctorAdaptor<typename KERNEL::Functor>, KERNEL>::value>::type> :
+   std::true_type {};
+
+template <EmbeddingType ET, Compress COMPRESS, PerLevelOrder PLO, class KERNEL>
+class CoordUniformPointSum;
+
+/**
+ * Selects CoordUniformPointSum for the figures of merit that it can evaluate.
+ *
+ * \c Enabled is \c true only for coordinate-uniform figures of merit of
+ * ordinary lattices with a kernel that satisfies HasPointValue.
+ */
+template <LatticeType LR, EmbeddingType ET, Compress COMPRESS, PerLevelOrder PLO, class FIGURE>
+struct PointSumSelector {
+   static constexpr bool Enabled = false;
+};
+
+template <EmbeddingType ET, Compress COMPRESS, PerLevelOrder PLO, class KERNEL>
+struct PointSumSelector<LatticeType::ORDINARY, ET, COMPRESS, PLO, CoordUniformFigureOfMerit<KERNEL>> {
+   typedef CoordUniformPointSum<ET, COMPRESS, PLO, KERNEL> PointSum;
+   static constexpr bool Enabled = HasPointValue<KERNEL>::value;
+};
+
+/**
+ * Point-by-point evaluation of weighted coordinate-uniform figures of merit
+ * for ordinary lattices.
+ *
+ * For each point \f$\boldsymbol x_i\f$ of the lattice, the term
+ * \f[
+ *    \sum_{\emptyset \neq \mathfrak u \subseteq \{1, \dots, s\}}
+ *    \gamma_{\mathfrak u} \prod_{j \in \mathfrak u} \omega(x_{i,j})
+ * \f]
+ * of the figure of merit (see CoordUniformCBC) is computed directly from the
+ * generating vector.  For product weights, it is equal to
+ * \f$\prod_{j=1}^s (1 + \gamma_j \omega(x_{i,j})) - 1\f$; for order-dependent
+ * and POD weights, the elementary symmetric sums of the terms
+ * \f$\gamma_j \omega(x_{i,j})\f$ are accumulated up to the largest order with
+ * a nonzero weight.  The terms are added in parallel by chunks of points with
+ * chunkedSum(), and the coordinates \f$i a_j \bmod n\f$ of the points are
+ * updated incrementally within each chunk.
+ *
+ * Unlike CoordUniformCBC, which stores the kernel values and the states at all
+ * the points, this needs memory proportional to the dimension only, for each
+ * chunk, at the price of evaluating the kernel \f$ns\f$ times.  It evaluates a
+ * single lattice; supports() tells whether the weights are supported.
+ */
+template <EmbeddingType ET, Compress COMPRESS, PerLevelOrder PLO, class KERNEL>
+class CoordUniformPointSum
+{
+public:
+   typedef typename Storage<LatticeType::ORDINARY, ET, COMPRESS, PLO>::MeritValue MeritValue;
+   typedef MeritValue value_type;
+   typedef LatBuilder::LatDef<LatticeType::ORDINARY, ET> LatDef;
+   typedef CoordUniformFigureOfMerit<KERNEL> FigureOfMerit;
+
+   /**
+    * Constructor.
+    *
+    * \param storage       Storage configuration; only its size parameter is
+    *                      used.
+    * \param figure        Coordinate-uniform figure of merit.  Kept as a
+    *                      reference, no copy made.
+    */
+   CoordUniformPointSum(
+         Storage<LatticeType::ORDINARY, ET, COMPRESS, PLO> storage,
+         const FigureOfMerit& figure
+         ):
+      m_storage(std::move(storage)),
+      m_figure(figure),
+      m_productWeights(nullptr),
+      m_orderWeights(nullptr)
+   {
+      const auto& weights = figure.weights();
+      if (const auto w = dynamic_cast<const LatticeTester::PODWeights*>(&weights)) {
+         m_productWeights = &w->getProductWeights();
+         m_orderWeights = &w->getOrderDependentWeights();
+      }
+      else {
+         m_productWeights = dynamic_cast<const LatticeTester::ProductWeights*>(&weights);
+         m_orderWeights = dynamic_cast<const LatticeTester::OrderDependentWeights*>(&weights);
+      }
+   }
+
+   /**
+    * Returns \c true if the weights of \c figure are product, order-dependent
+    * or POD weights.
+    */
+   static bool supports(const FigureOfMerit& figure)
+   {
+      const auto& weights = figure.weights();
+      return dynamic_cast<const LatticeTester::PODWeights*>(&weights)
+         or dynamic_cast<const LatticeTester::ProductWeights*>(&weights)
+         or dynamic_cast<const LatticeTester::OrderDependentWeights*>(&weights);
+   }
+
+   /**
+    * Returns the storage configuration instance.
+    */
+   const Storage<LatticeType::ORDINARY, ET, COMPRESS, PLO>& storage() const
+   { return m_storage; }
+
+   /**
+    * Returns the coordinate-uniform figure of merit.
+    */
+   const FigureOfMerit& figureOfMerit() const
+   { return m_figure; }
+
+   /**
+    * Returns the value of the figure of merit for lattice \c lat.
+    */
+   MeritValue operator()(const LatDef& lat) const
+   {
+      if (not m_productWeights and not m_orderWeights)
+         throw std::logic_error("CoordUniformPointSum: unsupported type of weights");
+      if (lat.sizeParam() != storage().sizeParam())
+         throw std::logic_error("storage and lattice size parameters do not match");
+
+      auto merit = sum(lat);
+      lat.sizeParam().normalize(merit);
+      return merit;
+   }
+
+   /**
+    * Sequence of merit values based on a sequence of lattice definitions.
+    *
+    * \tparam LATSEQ    Type of sequence of lattice definitions.
+    */
+   template <class LATSEQ>
+   class Seq :
+      public BridgeSeq<
+         Seq<LATSEQ>,
+         LATSEQ,
+         MeritValue,
+         BridgeIteratorCached>
+   {
+      typedef Seq<LATSEQ> self_type;
+
+   public:
+
+      typedef typename self_type::Base Base;
+      typedef typename self_type::value_type value_type;
+      typedef typename self_type::size_type size_type;
+
+      /**
+       * Constructor.
+       *
+       * \param parent     Reference to the parent.  Kept as a reference, no
+       *                   copy made.
+       * \param base       Base lattice sequence.
+       */
+      Seq(const CoordUniformPointSum& parent, Base base):
+         self_type::BridgeSeq_(std::move(base)),
+         m_parent(parent)
+      {}
+
+      /**
+       * Computes and returns the value of the figure of merit for the lattice
+       * pointed to by \c it.
+       */
+      value_type element(const typename Base::const_iterator& it) const
+      { return m_parent(*it); }
+
+   private:
+      const CoordUniformPointSum& m_parent;
+   };
+
+   /**
+    * Creates a new sequence of merit values based on a sequence of lattice
+    * definitions.
+    *
+    * \param latSeq    Sequence of lattice definitions.
+    */
+   template <typename LATSEQ>
+   Seq<LATSEQ> meritSeq(LATSEQ latSeq) const
+   { return Seq<LATSEQ>(*this, std::move(latSeq)); }
+
+private:
+   Storage<LatticeType::ORDINARY, ET, COMPRESS, PLO> m_storage;
+   const FigureOfMerit& m_figure;
+   const LatticeTester::ProductWeights* m_productWeights;
+   const LatticeTester::OrderDependentWeights* m_orderWeights;
+
+   Real sum(const LatBuilder::LatDef<LatticeType::ORDINARY, EmbeddingType::UNILEVEL>& lat) const
+   { return pointSum(lat, lat.sizeParam().numPoints(), 0); }
+
+   RealVector sum(const LatBuilder::LatDef<LatticeType::ORDINARY, EmbeddingType::MULTILEVEL>& lat) const
+   {
+      // level 0 is the origin; each level adds the points whose index is not
+      // a multiple of the base in the lattice of that level
+      const auto& sizeParam = lat.sizeParam();
+      RealVector out(sizeParam.maxLevel() + 1);
+      Real cumulative = 0.0;
+      for (Level level = 0; level <= sizeParam.maxLevel(); level++) {
+         cumulative += pointSum(lat, sizeParam.numPointsOnLevel(level), level == 0 ? 0 : sizeParam.base());
+         out[level] = cumulative;
+      }
+      return out;
+   }
+
+   /**
+    * Returns the sum of the terms for the points <tt>k / numPoints * a mod 1</tt>
+    * of lattice \c lat, for the indices \c k below \c numPoints that are not
+    * multiples of \c skip (for all indices if \c skip is 0).
+    */
+   Real pointSum(const LatDef& lat, uInteger numPoints, uInteger skip) const
+   {
+      const auto& gen = lat.gen();
+      const size_t dimension = gen.size();
+      const auto modulus = lat.sizeParam().modulus();
+      const auto& kernel = m_figure.kernel();
+
+      std::vector<uInteger> steps(dimension);
+      std::vector<Real> pweights(dimension, 1.0);
+      for (size_t j = 0; j < dimension; j++) {
+         steps[j] = gen[j] % numPoints;
+         if (m_productWeights)
+            pweights[j] = m_productWeights->getWeightForCoordinate(j);
+      }
+
+      // order-dependent weights of the orders up to the largest nonzero one
+      std::vector<Real> oweights;
+      if (m_orderWeights) {
+         const size_t maxOrder = std::min(dimension, numContributingOrders(*m_orderWeights));
+         oweights.resize(maxOrder + 1, 0.0);
+         for (size_t order = 1; order <= maxOrder; order++)
+            oweights[order] = m_orderWeights->getWeightForOrder(order);
+      }
+
+      return chunkedSum(numPoints, [&] (size_t begin, size_t end) {
+            std::vector<uInteger> index(dimension);
+            for (size_t j = 0; j < dimension; j++)
+               index[j] = mulMod(begin, steps[j], numPoints);
+            // elementary symmetric sums of the terms, by order
+            std::vector<Real> esum(oweights.size());
+
+            Real s = 0.0;
+            for (size_t k = begin; k < end; k++) {
+               const bool included = skip == 0 or k % skip != 0;
+               Real term = 1.0;
+               size_t maxOrder = 0;
+               if (included and not oweights.empty()) {
+                  std::fill(esum.begin(), esum.end(), 0.0);
+                  esum[0] = 1.0;
+               }
+               for (size_t j = 0; j < dimension; j++) {
+                  if (included and pweights[j] != 0.0) {
+                     const Real t = pweights[j] * kernel.pointValue(Real(index[j]) / numPoints, modulus);
+                     if (oweights.empty())
+                        term *= 1.0 + t;
+                     else {
+                        if (maxOrder + 1 < esum.size())
+                           maxOrder++;
+                        for (size_t order = maxOrder; order >= 1; order--)
+                           esum[order] += t * esum[order - 1];
+                     }
+                  }
+                  index[j] += steps[j];
+                  if (index[j] >= numPoints)
+                     index[j] -= numPoints;
+               }
+               if (not included)
+                  continue;
+               if (oweights.empty())
+                  s += term - 1.0;
+               else {
+                  for (size_t order = 1; order <= maxOrder; order++)
+                     s += oweights[order] * esum[order];
+               }
+            }
+            return s;
+            });
+   }
+};
+
+}}
+
+#endif
@@ -19,17 +19,51 @@
 
 #include "latbuilder/Types.h"
 #include "latbuilder/Storage.h"
+#include "latbuilder/Parallel.h"
 
+#include <algorithm>
+#include <limits>
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace LatBuilder { namespace MeritSeq {
 
+/**
+ * Scalar type used to store the state vectors that grow with the dimension
+ * (one vector per order or per projection).
+ *
+ * When LatNet Builder is configured with <code>--single-precision-states</code>,
+ * the macro \c LATBUILDER_SINGLE_PRECISION_STATES is defined and the states
+ * are stored in single precision, which halves their memory footprint.  The
+ * kernel values, the weighted state and all arithmetic remain in
+ * double precision.  Each update rounds the stored elements with a relative
+ * error of at most \f$2^{-24}\f$, but the merit values are inner products of
+ * terms of both signs for most kernels, so their relative error is larger:
+ * about \f$10^{-4}\f$ on the merit increments for the \f$\mathcal P_2\f$
+ * kernel with \f$n = 65537\f$, \f$s = 50\f$ and order-dependent weights.
+ * This is enough to rank candidates, but ties between close candidates may
+ * be broken differently than in double precision.
+ */
+#ifdef LATBUILDER_SINGLE_PRECISION_STATES
+typedef float StateReal;
+#else
+typedef Real StateReal;
+#endif
+
+/**
+ * Vector type used to store the state vectors.
+ */
+typedef boost::numeric::ublas::vector<StateReal,
+        boost::numeric::ublas::unbounded_array<StateReal, MappedAllocator<StateReal>>> StateVector;
+
 /**
  * Base base class for states used in the evaluation coordinate-uniform
  * figures of merit.
  *
  * The complete state is stored internally and can be updated with update().
- * The weighted state can be obtained with #weightedState().
+ * The weighted state can be obtained with #weightedState(), or computed in
+ * place into a reused buffer with weightedState(RealVector&, bool) const.
  *
  * \sa CoordUniformEval
  *
@@ -49,6 +83,22 @@ public:
       m_dimension(0)
    {}
 
+   /**
+    * Copy constructor.  The scratch buffer for the strided kernel values is
+    * not copied.
+    */
+   CoordUniformState(const CoordUniformState& other):
+      m_storage(other.m_storage),
+      m_dimension(other.m_dimension)
+   {}
+
+   CoordUniformState& operator=(const CoordUniformState& other)
+   {
+      m_storage = other.m_storage;
+      m_dimension = other.m_dimension;
+      return *this;
+   }
+
    virtual ~CoordUniformState()
    {}
 
@@ -75,7 +125,21 @@ public:
    /**
     * Computes and returns the weighted state vector \f$\boldsymbol q_s\f$.
     */
-   virtual RealVector weightedState() const = 0;
+   RealVector weightedState() const
+   {
+      RealVector out;
+      weightedState(out, false);
+      return out;
+   }
+
+   /**
+    * Computes the weighted state vector \f$\boldsymbol q_s\f$ into \c out.
+    *
+    * If \c accumulate is \c true, \f$\boldsymbol q_s\f$ is added to \c out,
+    * which must have the size of the storage; otherwise, \c out is resized if
+    * needed and overwritten.  No temporary vector is created.
+    */
+   virtual void weightedState(RealVector& out, bool accumulate) const = 0;
 
    /**
     * Returns a pointer to the storage configuration.
@@ -94,9 +158,139 @@ public:
     */
    virtual std::unique_ptr<CoordUniformState> clone() const = 0;
 
+protected:
+   /**
+    * Stores into \c out the kernel values permuted by the stride permutation
+    * of parameter \c gen.
+    *
+    * \see BasicStorage::gatherStrided()
+    */
+   void stridedKernelValues(
+         const RealVector& kernelValues,
+         typename LatticeTraits<LR>::GenValue gen,
+         RealVector& out
+         ) const
+   {
+      if (out.size() != m_storage.size())
+         out.resize(m_storage.size(), false);
+      m_storage.gatherStrided(kernelValues, gen, &out[0]);
+   }
+
+   /**
+    * Returns the kernel values permuted by the stride permutation of
+    * parameter \c gen, stored into a buffer that is reused across updates.
+    */
+   const RealVector& stridedKernelValues(
+         const RealVector& kernelValues,
+         typename LatticeTraits<LR>::GenValue gen
+         )
+   {
+      stridedKernelValues(kernelValues, gen, m_strided);
+      return m_strided;
+   }
+
+   /**
+    * Appends a new order to \c state and updates all orders in a single pass
+    * over memory, as
+    * \f[
+    *    \boldsymbol p_{s,\ell} =
+    *       \boldsymbol p_{s-1,\ell} + \gamma \, \boldsymbol\omega \odot \boldsymbol p_{s-1,\ell-1},
+    * \f]
+    * where \f$\gamma\f$ is \c factor.
+    *
+    * No new order is appended once \c state holds \c maxOrders vectors: the
+    * higher orders do not contribute to the lower ones, so they can be dropped
+    * when their weights are zero.
+    *
+    * The vectors are processed by blocks small enough to stay in the cache
+    * while all orders are updated, by decreasing order to avoid unwanted
+    * overwriting.
+    */
+   static void updateOrders(
+         std::vector<StateVector>& state,
+         const Real* omega,
+         Real factor,
+         size_t maxOrders = std::numeric_limits<size_t>::max()
+         )
+   {
+      const long size = static_cast<long>(state.front().size());
+      // a new order is entirely written by the first pass below
+      const bool newOrder = state.size() < maxOrders;
+      if (newOrder)
+         state.push_back(StateVector(size));
+
+      const long numOrders = static_cast<long>(state.size());
+      std::vector<StateReal*> data(numOrders);
+      for (long order = 0; order < numOrders; order++)
+         data[order] = size ? &state[order][0] : nullptr;
+
+      const long numBlocks = (size + BlockSize - 1) / BlockSize;
+      #pragma omp parallel for if(size >= static_cast<long>(MinParallelSize))
+      for (long block = 0; block < numBlocks; block++) {
+         const long begin = block * BlockSize;
+         const long end = std::min(begin + BlockSize, size);
+         long order = numOrders - 1;
+         if (newOrder) {
+            StateReal* cur = data[order];
+            const StateReal* prev = data[order - 1];
+            for (long i = begin; i < end; i++)
+               cur[i] = static_cast<StateReal>(factor * omega[i] * prev[i]);
+            order--;
+         }
+         for (; order > 0; order--) {
+            StateReal* cur = data[order];
+            const StateReal* prev = data[order - 1];
+            for (long i = begin; i < end; i++)
+               cur[i] = static_cast<StateReal>(cur[i] + factor * omega[i] * prev[i]);
+         }
+      }
+   }
+
+   /**
+    * Computes \f$\sum_k c_k \boldsymbol v_k\f$ into \c out in a single pass
+    * over \c out, where the pairs \f$(c_k, \boldsymbol v_k)\f$ are given by
+    * \c terms.
+    *
+    * If \c accumulate is \c true, the sum is added to \c out.  Otherwise,
+    * \c out is resized to \c size if needed and overwritten.
+    */
+   template <typename T>
+   static void weightedSum(
+         const std::vector<std::pair<Real, const T*>>& terms,
+         size_t size,
+         RealVector& out,
+         bool accumulate
+         )
+   {
+      if (!accumulate && out.size() != size)
+         out.resize(size, false);
+
+      const long n = static_cast<long>(size);
+      const long numBlocks = (n + BlockSize - 1) / BlockSize;
+      const long numTerms = static_cast<long>(terms.size());
+      Real* res = n ? &out[0] : nullptr;
+      #pragma omp parallel for if(size >= MinParallelSize)
+      for (long block = 0; block < numBlocks; block++) {
+         const long begin = block * BlockSize;
+         const long end = std::min(begin + BlockSize, n);
+         if (!accumulate)
+            std::fill(res + begin, res + end, Real(0.0));
+         for (long k = 0; k < numTerms; k++) {
+            const Real weight = terms[k].first;
+            const T* vec = terms[k].second;
+            for (long i = begin; i < end; i++)
+               res[i] += weight * vec[i];
+         }
+      }
+   }
+
 private:
+   // number of elements processed together by the fused loops (16 KiB)
+   static constexpr long BlockSize = 1 << 11;
+
    Storage<LR, ET, COMPRESS, PLO> m_storage;
    Dimension m_dimension;
+   RealVector m_strided; // scratch buffer for the strided kernel values
 };
 
 }}
@@ -0,0 +1,155 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * \file
+ * Out-of-core storage of large vectors in memory-mapped files.
+ */
+
+#ifndef LATBUILDER__OUT_OF_CORE_H
+#define LATBUILDER__OUT_OF_CORE_H
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <string>
+
+namespace LatBuilder {
+
+/**
+ * Out-of-core backend for large vectors.
+ *
+ * When a directory is set, every vector of at least #MinMappedBytes bytes
+ * allocated through MappedAllocator (which includes the kernel values, the
+ * coordinate-uniform states and the weighted states), as well as every large
+ * FFT buffer allocated by the FFTW wrapper (fftw::malloc_buffer()), is backed
+ * by an unlinked temporary file in that directory, mapped in memory.  The
+ * operating system then pages these vectors to and from the file instead of
+ * the swap area, so that the total size of the vectors may exceed the
+ * physical memory.
+ * The passes over the states are performed by cache-sized blocks, which keeps
+ * the accesses to the mapped files sequential.
+ *
+ * The directory is initialized from the \c LATNETBUILDER_OUT_OF_CORE
+ * environment variable and can be changed with setDirectory().  Out-of-core
+ * storage is disabled when the directory is empty, and on platforms without
+ * memory-mapped files.
+ */
+class OutOfCore {
+public:
+   /**
+    * Minimum size in bytes of the vectors stored in mapped files.
+    */
+   static constexpr size_t MinMappedBytes = size_t(1) << 26;
+
+   /**
+    * Sets the directory for the mapped files.  An empty string disables
+    * out-of-core storage.  Vectors that are already allocated are not
+    * affected.
+    */
+   static void setDirectory(std::string dir);
+
+   /**
+    * Returns the directory for the mapped files.
+    */
+   static const std::string& directory();
+
+   /**
+    * Allocates \c bytes bytes in a mapped file.
+    *
+    * \return A pointer to the mapped memory, or \c nullptr if out-of-core
+    * storage is disabled or if the file cannot be created.
+    */
+   static void* allocate(size_t bytes);
+
+   /**
+    * Releases the memory at \c p if it was allocated by allocate().
+    *
+    * \return \c true if \c p was released, \c false if it was not allocated by
+    * allocate().
+    */
+   static bool deallocate(void* p, size_t bytes);
+};
+
+/**
+ * Allocator that stores the large arrays in mapped files when out-of-core
+ * storage is enabled (see OutOfCore), and uses the standard allocator
+ * otherwise.
+ */
+template <typename T>
+class MappedAllocator {
+public:
+   typedef T value_type;
+   typedef T* pointer;
+   typedef const T* const_pointer;
+   typedef T& reference;
+   typedef const T& const_reference;
+   typedef std::size_t size_type;
+   typedef std::ptrdiff_t difference_type;
+
+   template <typename U>
+   struct rebind { typedef MappedAllocator<U> other; };
+
+   MappedAllocator() = default;
+
+   template <typename U>
+   MappedAllocator(const MappedAllocator<U>&)
+   {}
+
+   pointer allocate(size_type n)
+   {
+      if (n > max_size())
+         throw std::bad_alloc();
+      const size_t bytes = n * sizeof(T);
+      if (bytes >= OutOfCore::MinMappedBytes) {
+         if (void* p = OutOfCore::allocate(bytes))
+            return static_cast<pointer>(p);
+      }
+      return std::allocator<T>().allocate(n);
+   }
+
+   void deallocate(pointer p, size_type n)
+   {
+      const size_t bytes = n * sizeof(T);
+      if (bytes >= OutOfCore::MinMappedBytes and OutOfCore::deallocate(p, bytes))
+         return;
+      std::allocator<T>().deallocate(p, n);
+   }
+
+   size_type max_size() const
+   { return std::numeric_limits<size_type>::max() / sizeof(T); }
+
+   template <typename U, typename... ARGS>
+   void construct(U* p, ARGS&&... args)
+   { ::new (static_cast<void*>(p)) U(std::forward<ARGS>(args)...); }
+
+   template <typename U>
+   void destroy(U* p)
+   { p->~U(); }
+};
+
+template <typename T, typename U>
+bool operator==(const MappedAllocator<T>&, const MappedAllocator<U>&)
+{ return true; }
+
+template <typename T, typename U>
+bool operator!=(const MappedAllocator<T>&, const MappedAllocator<U>&)
+{ return false; }
+
+}
+
+#endif
@@ -0,0 +1,151 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * \file
+ * Helpers for shared-memory parallelism.
+ *
+ * Parallel loops are written with OpenMP directives.  When LatNet Builder is
+ * compiled without OpenMP support, the directives are ignored and the loops
+ * are executed sequentially.  The number of threads is controlled with the
+ * \c OMP_NUM_THREADS environment variable.
+ */
+
+#ifndef LATBUILDER__PARALLEL_H
+#define LATBUILDER__PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace LatBuilder {
+
+/**
+ * Minimum number of vector elements for which a loop over the elements is
+ * split across threads.  Below this size, the cost of starting a parallel
+ * region exceeds that of the loop.
+ */
+constexpr size_t MinParallelSize = 1 << 14;
+
+/**
+ * Number of consecutive terms added sequentially by chunkedSum().
+ */
+constexpr size_t SumChunkSize = 1 << 12;
+
+/**
+ * Returns the sum of \c size terms, computed in parallel.
+ *
+ * The indices of the terms are split into chunks of #SumChunkSize consecutive
+ * indices, and \c chunkSum(begin, end) is called on each chunk, in parallel,
+ * to obtain the sum of the terms with indices in <tt>[begin, end)</tt>.
+ * The partial sums are then added pairwise.  The chunks do not depend on the
+ * number of threads, so neither does the result, and the rounding error
+ * grows only logarithmically with the number of chunks.  The memory used is
+ * one value per chunk.
+ */
+template <class FUNC>
+auto chunkedSum(size_t size, FUNC chunkSum) -> decltype(chunkSum(size_t(0), size_t(0)))
+{
+   typedef decltype(chunkSum(size_t(0), size_t(0))) T;
+   if (size <= SumChunkSize)
+      return size ? chunkSum(size_t(0), size) : T(0);
+
+   const long numChunks = static_cast<long>((size - 1) / SumChunkSize + 1);
+   std::vector<T> partial(numChunks);
+   #pragma omp parallel for if(size >= MinParallelSize)
+   for (long c = 0; c < numChunks; c++) {
+      const size_t begin = static_cast<size_t>(c) * SumChunkSize;
+      partial[c] = chunkSum(begin, std::min(begin + SumChunkSize, size));
+   }
+
+   for (size_t step = 1; step < partial.size(); step *= 2) {
+      for (size_t i = 0; i + step < partial.size(); i += 2 * step)
+         partial[i] += partial[i + step];
+   }
+   return partial[0];
+}
+
+/**
+ * Returns the maximum number of threads available to a parallel region.
+ */
+inline int maxThreads()
+{
+#ifdef _OPENMP
+   return omp_get_max_threads();
+#else
+   return 1;
+#endif
+}
+
+/**
+ * Returns the number of the calling thread within its team.
+ */
+inline int threadNum()
+{
+#ifdef _OPENMP
+   return omp_get_thread_num();
+#else
+   return 0;
+#endif
+}
+
+/**
+ * Returns \c true if called from inside an active parallel region.
+ */
+inline bool inParallel()
+{
+#ifdef _OPENMP
+   return omp_in_parallel();
+#else
+   return false;
+#endif
+}
+
+/**
+ * Returns a reference to the flag which enables the parallel evaluation of
+ * the projections of weighted figures of merit (disabled by default).
+ */
+inline bool& parallelProjectionsFlag()
+{
+   static bool enabled = false;
+   return enabled;
+}
+
+/**
+ * Enables or disables the parallel evaluation of the projections of weighted
+ * figures of merit.
+ *
+ * This pays off only when the projection-dependent merit is expensive to
+ * compute, as for spectral figures of merit in high dimension; otherwise, the
+ * parallel regions cost more than they save.
+ */
+inline void setParallelProjections(bool enabled)
+{ parallelProjectionsFlag() = enabled; }
+
+/**
+ * Returns \c true if the projections of weighted figures of merit are
+ * evaluated in parallel.
+ */
+inline bool parallelProjections()
+{ return parallelProjectionsFlag(); }
+
+}
+
+#endif
@@ -41,6 +41,44 @@
 
 namespace LatBuilder { namespace Parser {
 
+namespace detail {
+   /**
+    * Creates a fast CBC search.
+    */
+   template <LatticeType LR, LatBuilder::EmbeddingType ET>
+   struct FastCBCSelector {
+      template <class FIGURE, Compress COMPRESS, PerLevelOrder PLO, class FUNC, typename... ARGS>
+      static void create(
+            Storage<LR, ET, COMPRESS, PLO> storage,
+            LatBuilder::Dimension dimension,
+            FIGURE figure,
+            FUNC&& func, ARGS&&... args
+            )
+      { func(Task::fastCBC(std::move(storage), dimension, std::move(figure)), std::forward<ARGS>(args)...); }
+   };
+
+   /**
+    * Creates a fast CBC search for unilevel ordinary lattices.  The CRT-based
+    * variant is selected when the number of points is not a prime power.
+    */
+   template <>
+   struct FastCBCSelector<LatticeType::ORDINARY, LatBuilder::EmbeddingType::UNILEVEL> {
+      template <class FIGURE, Compress COMPRESS, PerLevelOrder PLO, class FUNC, typename... ARGS>
+      static void create(
+            Storage<LatticeType::ORDINARY, LatBuilder::EmbeddingType::UNILEVEL, COMPRESS, PLO> storage,
+            LatBuilder::Dimension dimension,
+            FIGURE figure,
+            FUNC&& func, ARGS&&... args
+            )
+      {
+         if (primeFactorsMap(storage.sizeParam().modulus()).size() > 1)
+            func(Task::compositeFastCBC(std::move(storage), dimension, std::move(figure)), std::forward<ARGS>(args)...);
+         else
+            func(Task::fastCBC(std::move(storage), dimension, std::move(figure)), std::forward<ARGS>(args)...);
+      }
+   };
+}
+
 /**
  * Parser for coordinate-uniform figures of merit.
  */
@@ -101,7 +139,7 @@ public:
          return;
       }
       if (str == "fast-CBC") {
-         func(Task::fastCBC(std::move(storage), dimension, std::move(figure)), std::forward<ARGS>(args)...);
+         detail::FastCBCSelector<LR, ET>::create(std::move(storage), dimension, std::move(figure), std::forward<FUNC>(func), std::forward<ARGS>(args)...);
          return;
       }
       if (str == "Korobov") {
@@ -127,9 +127,10 @@ public:
          throw std::logic_error("storage and lattice size parameters do not match");
 
       RealVector prod(m_storage.size(), 1.0);
+      RealVector stridedKernel(m_storage.size());
 
       for (const auto coord : projection) {
-         const auto stridedKernel = m_storage.strided(m_kernelValues, lat.gen()[coord]);
+         m_storage.gatherStrided(m_kernelValues, lat.gen()[coord], &stridedKernel[0]);
          prod = boost::numeric::ublas::element_prod(prod, stridedKernel);
       }
 
@@ -25,9 +25,14 @@
 #include "latticetester/Rank1Lattice.h"
 #include "latticetester/Reducer.h"
 
+#include <atomic>
+#include <cmath>
 #include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
-#include <cmath>
+#include <vector>
 
 namespace LatBuilder { namespace ProjDepMerit {
 
@@ -91,58 +96,141 @@ private:
 };
 
 namespace detail {
-   template <class NORM, Compress COMPRESS, EmbeddingType ET>
-   Real spectralEval(
-            const Storage<LatticeType::ORDINARY, EmbeddingType::UNILEVEL, COMPRESS>& storage,
-            const LatDef<LatticeType::ORDINARY, ET>& lat,
-            const LatticeTester::Coordinates& projection,
+   /**
+    * Cache of the normalization constants of the spectral figure of merit.
+    *
+    * The constant depends only on the number of points and on the order of
+    * the projection, so it is computed with a new normalizer only once for
+    * each pair.  The constants for the numbers of points given to the
+    * constructor and for orders below #TableOrders are kept in a table of
+    * atomic values that is read without locking; only the other orders go
+    * through a map protected by a mutex.  The cache can be used concurrently
+    * by several threads.
+    */
+   template <class NORM>
+   class SpectralNormalization {
+   public:
+      /// Number of orders whose constants are kept in the lock-free table.
+      static constexpr size_t TableOrders = 64;
+
+      /**
+       * Constructor.
+       *
+       * \param numPoints   Numbers of points, for instance on each level of an
+       *                    embedded lattice.
+       */
+      explicit SpectralNormalization(std::vector<uInteger> numPoints):
+         m_numPoints(std::move(numPoints)),
+         m_table(m_numPoints.size() * TableOrders)
+      {
+         for (auto& value : m_table)
+            value.store(0.0, std::memory_order_relaxed);
+      }
+
+      /**
+       * Returns the square of the normalization constant for a projection of
+       * order \c order and the number of points of index \c index in the
+       * list given to the constructor.
+       */
+      Real operator()(size_t index, size_t order)
+      {
+         if (order < TableOrders) {
+            // concurrent threads that miss the same entry compute the same
+            // value, so that a relaxed store is enough
+            auto& value = m_table[index * TableOrders + order];
+            Real v = value.load(std::memory_order_relaxed);
+            if (v == 0.0) {
+               v = compute(m_numPoints[index], order);
+               value.store(v, std::memory_order_relaxed);
+            }
+            return v;
+         }
+         std::lock_guard<std::mutex> lock(m_mutex);
+         auto& values = m_values[m_numPoints[index]];
+         if (values.size() <= order)
+            values.resize(order + 1, 0.0);
+         if (values[order] == 0.0)
+            values[order] = compute(m_numPoints[index], order);
+         return values[order];
+      }
+
+   private:
+      std::vector<uInteger> m_numPoints;
+      std::vector<std::atomic<Real>> m_table;
+      std::mutex m_mutex;
+      std::map<uInteger, std::vector<Real>> m_values;
+
+      static Real compute(uInteger numPoints, size_t order)
+      {
+         // Ref:
+         //   P. L'Ecuyer and C. Lemieux.
+         //   Variance Reduction via Lattice Rules.
+         //   Management Science, 46, 9 (2000), 1214-1235.
+         NORM normalizer(
+               log(numPoints),
+               // 1 /* lattice rank */,
+               static_cast<int>(order));
+
+         if (normalizer.getNorm () != LatticeTester::L2NORM)
+            // this is the L2NORM implementation
+            throw std::invalid_argument ("norm of normalizer must be L2NORM");
+
+         return normalizer.getGamma(static_cast<int>(order)) * std::pow(numPoints, 2.0 / order);
+      }
+   };
+
+   /**
+    * Returns the square length of the shortest nonzero vector of the dual
+    * lattice \f$\{\boldsymbol h \in \mathbb Z^d : \boldsymbol h \cdot
+    * \boldsymbol a \equiv 0 \pmod n\}\f$ of a projection of order
+    * \f$d \leq 3\f$, without going through LatticeTester.
+    *
+    * The dual basis is reduced exactly with Lagrange-Gauss reduction for
+    * \f$d = 2\f$ and with the greedy reduction of Nguyen and Stehle, which
+    * yields a Minkowski-reduced basis, for \f$d = 3\f$.
+    *
+    * \return The square length, or 0 if \f$d > 3\f$ or if no component of
+    * \c gen is invertible modulo \c numPoints.
+    */
+   Real lowOrderShortestDualVector(uInteger numPoints, const std::int64_t* gen, size_t order);
+
+   /**
+    * Returns the spectral figure of merit for the projection of a lattice with
+    * \c numPoints points with projected generating vector \c gen.
+    *
+    * \param sqlength0  Square of the normalization constant (see
+    *                   SpectralNormalization).
+    */
+   inline Real spectralEval(
+            uInteger numPoints,
+            const NTL::vector<std::int64_t>& gen,
+            Real sqlength0,
             Real power
             )
    {
-      typedef NORM Normalizer;
-
-      // Ref:
-      //   P. L'Ecuyer and C. Lemieux.
-      //   Variance Reduction via Lattice Rules.
-      //   Management Science, 46, 9 (2000), 1214-1235.
-      Real logDensity = log(lat.sizeParam().numPoints());
-      Normalizer normalizer(
-            logDensity,
-            // 1 /* lattice rank */,
-            static_cast<int>(projection.size()));
-      // idea: we could cache the normalizer values for each projection size
-      // (check in the profiler first if this is worth it)
-
-      if (normalizer.getNorm () != LatticeTester::L2NORM)
-         // this is the L2NORM implementation
-         throw std::invalid_argument ("norm of normalizer must be L2NORM");
-
-      // if (projection.size() <= 1)
-      // throw std::invalid_argument("projection order must be >= 2");
-
-      // extract projection of the generating vector
-      NTL::vector<std::int64_t> gen(projection.size());
-      {
-         // first component is not used
-         size_t j = 0;
-         for (const auto& coord : projection){
-               gen(j) = lat.gen()[coord];
-                  j++;
-         }   
-      }
+      const int order = static_cast<int>(gen.length());
 
 #ifdef DEBUG
       using TextStream::operator<<;
       std::cout << "      projected generator: " << gen << std::endl;
 #endif
 
+      if (order <= 3) {
+         std::int64_t g[3];
+         for (int j = 0; j < order; j++)
+            g[j] = gen(j);
+         const Real sqlength = lowOrderShortestDualVector(numPoints, g, static_cast<size_t>(order));
+         if (sqlength > 0.0)
+            return std::pow(std::sqrt(sqlength0 / sqlength), power);
+      }
+
       // prepare lattice and basis reduction
       LatticeTester::Rank1Lattice<std::int64_t, std::int64_t, Real, Real> lattice(
-            lat.sizeParam().numPoints(),
+            numPoints,
             gen,
-            static_cast<int>(projection.size()),
-            normalizer.getNorm());
-      lattice.buildBasis (static_cast<int>(projection.size()));
+            order,
+            LatticeTester::L2NORM);
+      lattice.buildBasis (order);
       lattice.dualize ();
 
       LatticeTester::Reducer<std::int64_t, std::int64_t, Real, Real> reducer(lattice);
@@ -161,12 +249,6 @@ namespace detail {
       // square length
       Real sqlength = lattice.getVecNorm(0); 
 
-      // normalization
-      Real sqlength0 =
-         normalizer.getGamma(static_cast<int>(projection.size())) * std::pow(
-                           lat.sizeParam().numPoints(),
-               2.0 / projection.size());
-
       Real merit = std::sqrt (sqlength0 / sqlength);
 
 #ifdef DEBUG
@@ -181,34 +263,32 @@ namespace detail {
       return Real(pow(merit, power));
    }
 
-   template <class NORM, Compress COMPRESS, EmbeddingType ET>
-   RealVector spectralEval(
-            const Storage<LatticeType::ORDINARY, EmbeddingType::MULTILEVEL, COMPRESS>& storage,
+   /**
+    * Returns the components of the generating vector of \c lat that belong to
+    * \c projection.
+    */
+   template <EmbeddingType ET>
+   NTL::vector<std::int64_t> projectedGenerator(
             const LatDef<LatticeType::ORDINARY, ET>& lat,
-            const LatticeTester::Coordinates& projection,
-            Real power
+            const LatticeTester::Coordinates& projection
             )
    {
-      RealVector out(storage.sizeParam().maxLevel() + 1, 0.0);
-      auto itOut = out.begin();
-
-      for (Level level = 0; level <= storage.sizeParam().maxLevel(); level++) {
-
-         typename Storage<LatticeType::ORDINARY, EmbeddingType::UNILEVEL, COMPRESS>::SizeParam osize(storage.sizeParam().numPointsOnLevel(level));
-         Storage<LatticeType::ORDINARY, EmbeddingType::UNILEVEL, COMPRESS> ostorage(osize);
-
-         auto olat = createLatDef(osize, lat.gen());
-
-         *itOut = spectralEval<NORM>(ostorage, olat, projection, power);
-
-         ++itOut;
+      NTL::vector<std::int64_t> gen(projection.size());
+      size_t j = 0;
+      for (const auto& coord : projection){
+         gen(j) = lat.gen()[coord];
+         j++;
       }
-      return out;
+      return gen;
    }
 }
 
 /**
  * Evaluator for coordinate-uniform projeciton-dependent figures of merit.
+ *
+ * The normalization constants are cached for each number of points and
+ * projection order.  For embedded lattices, all levels are evaluated with the
+ * same projected generating vector.
  */
 template <class NORM, EmbeddingType ET, Compress COMPRESS, PerLevelOrder PLO >
 class Evaluator<Spectral<NORM>,LatticeType::ORDINARY, ET, COMPRESS, PLO> {
@@ -220,7 +300,8 @@ public:
       Real power
       ):
       m_storage(std::move(storage)),
-      m_power(std::move(power))
+      m_power(std::move(power)),
+      m_normalization(std::make_shared<detail::SpectralNormalization<NORM>>(levelNumPoints(m_storage)))
    {}
 
    /**
@@ -244,12 +325,47 @@ public:
       if (m_storage.sizeParam() != lat.sizeParam())
          throw std::logic_error("storage and lattice size parameters do not match");
 
-      return detail::spectralEval<NORM>(m_storage, lat, projection, m_power);
+      return eval(detail::projectedGenerator(lat, projection), m_storage);
    }
 
 private:
    Storage<LatticeType::ORDINARY, ET, COMPRESS> m_storage;
    Real m_power;
+   std::shared_ptr<detail::SpectralNormalization<NORM>> m_normalization;
+
+   static std::vector<uInteger> levelNumPoints(const Storage<LatticeType::ORDINARY, EmbeddingType::UNILEVEL, COMPRESS>& storage)
+   { return std::vector<uInteger>{storage.sizeParam().numPoints()}; }
+
+   static std::vector<uInteger> levelNumPoints(const Storage<LatticeType::ORDINARY, EmbeddingType::MULTILEVEL, COMPRESS>& storage)
+   {
+      std::vector<uInteger> numPoints;
+      for (Level level = 0; level <= storage.sizeParam().maxLevel(); level++)
+         numPoints.push_back(storage.sizeParam().numPointsOnLevel(level));
+      return numPoints;
+   }
+
+   Real eval(uInteger numPoints, size_t index, const NTL::vector<std::int64_t>& gen) const
+   {
+      const Real sqlength0 = (*m_normalization)(index, static_cast<size_t>(gen.length()));
+      return detail::spectralEval(numPoints, gen, sqlength0, m_power);
+   }
+
+   Real eval(
+         const NTL::vector<std::int64_t>& gen,
+         const Storage<LatticeType::ORDINARY, EmbeddingType::UNILEVEL, COMPRESS>& storage
+         ) const
+   { return eval(storage.sizeParam().numPoints(), 0, gen); }
+
+   RealVector eval(
+         const NTL::vector<std::int64_t>& gen,
+         const Storage<LatticeType::ORDINARY, EmbeddingType::MULTILEVEL, COMPRESS>& storage
+         ) const
+   {
+      RealVector out(storage.sizeParam().maxLevel() + 1, 0.0);
+      for (Level level = 0; level <= storage.sizeParam().maxLevel(); level++)
+         out[level] = eval(storage.sizeParam().numPointsOnLevel(level), level, gen);
+      return out;
+   }
 };
 
 }}
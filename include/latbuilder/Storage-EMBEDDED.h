@@ -21,6 +21,7 @@
 #include "latbuilder/GenSeq/CyclicGroup.h"
 #include "latbuilder/GenSeq/GeneratingValues.h"
 
+#include <algorithm>
 #include <map>
 #include <stdexcept>
 
@@ -298,6 +299,60 @@ struct StorageTraits<Storage<LR, EmbeddingType::MULTILEVEL, COMPRESS, PLO>> {
       size_type size() const
       { return m_storage.size(); }
 
+      /**
+       * Stores into \c out the elements of \c vec permuted by the stride.
+       *
+       * The elements are processed level by level, which avoids looking up
+       * the level of each element.  With the inverse-cyclic per-level order,
+       * the stride rotates each circulant block by the same number of
+       * positions, so each block is gathered as two contiguous runs.
+       */
+      template <class V, class T>
+      void gather(const V& vec, T* out) const
+      {
+         const size_type total = size();
+         const size_type seqsize = m_storage.indices().size();
+         const auto base = m_storage.sizeParam().base();
+         size_type start = 0;
+         for (Level level = 0; start < total; level++) {
+            const auto& subgroup = m_storage.indices(level);
+            const size_type stop = std::min<size_type>(start + subgroup.size(), total);
+
+            if (PLO == PerLevelOrder::CYCLIC) {
+               size_type blockSize = subgroup.size();
+               bool reverse = false;
+               if (LR == LatticeType::ORDINARY and not Compress::symmetric() and base == (value_type)(2) and blockSize >= 2) {
+                  // two circulant half-blocks, swapped for the rows of the second half
+                  reverse = m_row >= seqsize / 2;
+                  blockSize /= 2;
+               }
+               const size_type shift = (seqsize - m_row) % blockSize;
+               for (size_type dst = start, half = 0; dst < stop; dst += blockSize, half++) {
+                  const size_type src = start + (((half & 1) != 0) != reverse ? blockSize : 0);
+                  const size_type count = std::min(blockSize, stop - dst);
+                  const size_type wrap = blockSize - shift;
+                  const long lcount = static_cast<long>(count);
+                  #pragma omp parallel for if(count >= MinParallelSize)
+                  for (long o = 0; o < lcount; o++) {
+                     const size_type k = static_cast<size_type>(o);
+                     out[dst + k] = vec[src + (k < wrap ? shift + k : k - wrap)];
+                  }
+               }
+            }
+            else {
+               const long lcount = static_cast<long>(stop - start);
+               #pragma omp parallel for if(LR != LatticeType::POLYNOMIAL and stop - start >= MinParallelSize)
+               for (long o = 0; o < lcount; o++) {
+                  const size_type k = static_cast<size_type>(o);
+                  const value_type x = (level == 0) ? value_type(1) : Compress::compressIndex((subgroup[k] * m_stride) % subgroup.modulus(), subgroup.modulus());
+                  out[start + k] = vec[start + LatticeTraits<LR>::ToIndex(x % base) +
+                     (LatticeTraits<LR>::NumPoints(base) - 1) * LatticeTraits<LR>::ToIndex(x / base) - 1];
+               }
+            }
+            start = stop;
+         }
+      }
+
    private:
       Storage<LR, EmbeddingType::MULTILEVEL, COMPRESS, PLO> m_storage;
       value_type m_stride;
@@ -86,6 +86,18 @@ struct StorageTraits<Storage<LatticeType::DIGITAL, EmbeddingType::UNILEVEL, COMP
       size_type size() const
       { return m_storage.size(); }
 
+      /**
+       * Stores into \c out the elements of \c vec permuted by the stride.
+       */
+      template <class V, class T>
+      void gather(const V& vec, T* out) const
+      {
+         const long size = static_cast<long>(this->size());
+         #pragma omp parallel for if(this->size() >= MinParallelSize)
+         for (long i = 0; i < size; i++)
+            out[i] = vec[Compress::compressIndex(m_permutation[i], m_storage.virtualSize())];
+      }
+
    private:
       Storage<LatticeType::DIGITAL, EmbeddingType::UNILEVEL, COMPRESS> m_storage;
       value_type m_stride;
@@ -20,6 +20,11 @@
 #include "latbuilder/Storage.h"
 #include "latbuilder/CompressTraits.h"
 #include "latbuilder/SizeParam.h"
+#include "latbuilder/Util.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
 
 namespace LatBuilder {
 
@@ -90,9 +95,83 @@ struct StorageTraits<Storage<LR, EmbeddingType::UNILEVEL, COMPRESS>> {
       size_type size() const
       { return m_storage.size(); }
 
+      /**
+       * Stores into \c out the elements of \c vec permuted by the stride.
+       *
+       * For ordinary lattices, the permuted index of element \f$i+1\f$ is
+       * obtained from that of element \f$i\f$ by adding \f$a\f$ and
+       * subtracting \f$n\f$ if necessary.
+       * For polynomial lattices, the permutation is linear over
+       * \f$\mathbb{Z}_2\f$, so the permuted indices are obtained by combining
+       * with exclusive or the images of the monomials \f$z^k\f$.
+       * In both cases, the elements are processed by blocks, in parallel.
+       */
+      template <class V, class T>
+      void gather(const V& vec, T* out) const
+      { gather(vec, out, std::integral_constant<LatticeType, LR>()); }
+
    private:
       Storage<LR, EmbeddingType::UNILEVEL, COMPRESS> m_storage;
       value_type m_stride;
+
+      static constexpr unsigned int BlockBits = 12;
+
+      template <class V, class T>
+      void gather(const V& vec, T* out, std::integral_constant<LatticeType, LatticeType::ORDINARY>) const
+      {
+         const size_type n = m_storage.sizeParam().numPoints();
+         const size_type a = m_stride % n;
+         const size_type size = this->size();
+         const long numBlocks = static_cast<long>(((size - 1) >> BlockBits) + 1);
+         #pragma omp parallel for if(size >= MinParallelSize)
+         for (long b = 0; b < numBlocks; b++) {
+            const size_type begin = static_cast<size_type>(b) << BlockBits;
+            const size_type end = std::min(begin + (size_type(1) << BlockBits), size);
+            size_type j = mulMod(begin, a, n);
+            for (size_type i = begin; i < end; i++) {
+               out[i] = vec[Compress::compressIndex(j, n)];
+               j += a;
+               if (j >= n)
+                  j -= n;
+            }
+         }
+      }
+
+      template <class V, class T>
+      void gather(const V& vec, T* out, std::integral_constant<LatticeType, LatticeType::POLYNOMIAL>) const
+      {
+         const auto& modulus = m_storage.sizeParam().modulus();
+         const size_type n = m_storage.sizeParam().numPoints();
+         const size_type size = this->size();
+
+         // indices of q(z) z^k mod P(z)
+         std::vector<size_type> image;
+         for (size_type k = 1; k < n; k <<= 1)
+            image.push_back(LatticeTraits<LR>::ToIndex(m_stride * LatticeTraits<LR>::ToGenValue(k) % modulus));
+
+         // images of the indices below 2^lowBits
+         const unsigned int lowBits = image.size() < BlockBits ? image.size() : BlockBits;
+         std::vector<size_type> low(size_type(1) << lowBits, 0);
+         for (unsigned int k = 0; k < lowBits; k++) {
+            const size_type half = size_type(1) << k;
+            for (size_type j = 0; j < half; j++)
+               low[half + j] = low[j] ^ image[k];
+         }
+
+         const long numBlocks = static_cast<long>(((size - 1) >> lowBits) + 1);
+         #pragma omp parallel for if(size >= MinParallelSize)
+         for (long b = 0; b < numBlocks; b++) {
+            size_type high = 0;
+            for (unsigned int k = lowBits; k < image.size(); k++) {
+               if ((static_cast<size_type>(b) >> (k - lowBits)) & 1)
+                  high ^= image[k];
+            }
+            const size_type begin = static_cast<size_type>(b) << lowBits;
+            const size_type end = std::min(begin + low.size(), size);
+            for (size_type i = begin; i < end; i++)
+               out[i] = vec[Compress::compressIndex(high ^ low[i - begin], n)];
+         }
+      }
    };
 
 };
@@ -19,6 +19,7 @@
 
 #include "latbuilder/Types.h"
 #include "latbuilder/IndexMap.h"
+#include "latbuilder/Parallel.h"
 
 #include <boost/numeric/ublas/vector_proxy.hpp>
 
@@ -211,6 +212,28 @@ public:
             );
    }
 
+   /**
+    * Stores into \c out the elements of strided(vec, stride), in the same
+    * order.
+    *
+    * Instead of computing the permuted index of every element independently,
+    * the stride permutation visits the elements incrementally or by blocks,
+    * which avoids the integer (or polynomial) modulo in the inner loop.
+    * The array \c out must have room for size() elements; nothing is written
+    * if size() is zero.
+    */
+   template <class V, class T>
+   void gatherStrided(
+         const boost::numeric::ublas::vector_container<V>& vec,
+         value_type stride,
+         T* out
+         ) const
+   {
+      if (size() == 0)
+         return;
+      Stride(derived(), stride).gather(vec(), out);
+   }
+
 private:
    SizeParam m_sizeParam;
 
@@ -57,7 +57,6 @@ public:
       CBCBasedSearchTraits<TAG>::Search(dimension),
       m_storage(std::move(storage)),
       m_figure(new FigureOfMerit(std::move(figure))),
-      m_cbc(new CBC(this->storage(), this->figureOfMerit())),
       m_traits(std::move(traits))
    { m_traits.init(*this); }
 
@@ -74,7 +73,8 @@ public:
    virtual void reset()
    {
       CBCBasedSearchTraits<TAG>::Search::reset();
-      m_cbc->reset();
+      if (m_cbc)
+         m_cbc->reset();
    }
 
    virtual void execute()
@@ -106,11 +106,24 @@ public:
 
    /**
     * Returns the internal CBC instance.
+    *
+    * The CBC instance, together with its storage for the kernel values and
+    * the states, is created on first use.
     */
    CBC& cbc()
-   { return *m_cbc; }
+   {
+      if (not m_cbc)
+         m_cbc.reset(new CBC(storage(), figureOfMerit()));
+      return *m_cbc;
+   }
 
 protected:
+   /**
+    * Returns the traits instance.
+    */
+   const Traits& traits() const
+   { return m_traits; }
+
    virtual void format(std::ostream& os) const
    {
       os << m_traits.name() << std::endl;
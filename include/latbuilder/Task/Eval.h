@@ -23,9 +23,12 @@
 #include "latbuilder/WeightedFigureOfMerit.h"
 #include "latbuilder/CoordUniformFigureOfMerit.h"
 #include "latbuilder/MeritSeq/CBC.h"
+#include "latbuilder/MeritSeq/CoordUniformPointSum.h"
 #include "latbuilder/GenSeq/GeneratingValues.h"
+#include "latbuilder/LatDef.h"
 #include "latbuilder/Util.h"
 
+#include <type_traits>
 #include <vector>
 
 namespace LatBuilder { namespace Task {
@@ -34,9 +37,8 @@ template <LatticeType LR, EmbeddingType ET, Compress COMPRESS, PerLevelOrder PLO
 struct EvalTag {};
 
 
-/// Explicit construction (evaluates a figure of merit for a single lattice).
-template <LatticeType LR, EmbeddingType ET, Compress COMPRESS, PerLevelOrder PLO, class FIGURE> using Eval =
-   CBCBasedSearch<EvalTag<LR, ET, COMPRESS, PLO, FIGURE>>;
+template <LatticeType LR, EmbeddingType ET, Compress COMPRESS, PerLevelOrder PLO, class FIGURE>
+class Eval;
 
 
 /// Explicit construction (evaluates a figure of merit for a single lattice).
@@ -50,6 +52,26 @@ Eval<LR, ET, COMPRESS, PLO, FIGURE> eval(
 { return Eval<LR, ET, COMPRESS, PLO, FIGURE>(std::move(storage), dimension, std::move(figure), std::move(genVec)); }
 
 
+/**
+ * Connects the progress of the CBC algorithm with the minimum observer of the
+ * evaluation task \c search.
+ */
+template <class SEARCH, class FIGURE>
+void connectEvalProgress(SEARCH& search, const FIGURE&)
+{ connectCBCProgress(search.cbc(), search.minObserver(), search.filters().empty()); }
+
+/**
+ * Does nothing.
+ *
+ * There is no progress to connect for coordinate-uniform figures of merit,
+ * and the CBC instance is not created if the lattice is evaluated point by
+ * point.
+ */
+template <class SEARCH, class KERNEL>
+void connectEvalProgress(SEARCH& search, const CoordUniformFigureOfMerit<KERNEL>&)
+{}
+
+
 template <LatticeType LR, EmbeddingType ET, Compress COMPRESS, PerLevelOrder PLO, class FIGURE>
 struct CBCBasedSearchTraits<EvalTag<LR, ET, COMPRESS, PLO, FIGURE>> {
    typedef LatBuilder::Task::Search<LR, ET> Search;
@@ -79,13 +101,85 @@ struct CBCBasedSearchTraits<EvalTag<LR, ET, COMPRESS, PLO, FIGURE>> {
       stream << "Task: LatBuilder Evaluation of a " << to_string(LR) << " lattice";
       return stream.str(); }
 
-   void init(LatBuilder::Task::Eval<LR, ET, COMPRESS, PLO, FIGURE>& search) const
-   { connectCBCProgress(search.cbc(), search.minObserver(), search.filters().empty()); }
+   void init(CBCBasedSearch<EvalTag<LR, ET, COMPRESS, PLO, FIGURE>>& search) const
+   { connectEvalProgress(search, search.figureOfMerit()); }
 
    GeneratingVector genVec;
 };
 
+/**
+ * Evaluation task.
+ *
+ * The figure of merit is evaluated coordinate by coordinate with the CBC
+ * algorithm, except for coordinate-uniform figures of merit of ordinary
+ * lattices with a kernel that supports MeritSeq::CoordUniformPointSum and with
+ * product, order-dependent or POD weights, which are evaluated point by point
+ * in bounded memory.  In that case, only the merit value of the lattice in the
+ * full dimension is reported.
+ */
+template <LatticeType LR, EmbeddingType ET, Compress COMPRESS, PerLevelOrder PLO, class FIGURE>
+class Eval : public CBCBasedSearch<EvalTag<LR, ET, COMPRESS, PLO, FIGURE>> {
+   typedef CBCBasedSearch<EvalTag<LR, ET, COMPRESS, PLO, FIGURE>> Base;
+   typedef MeritSeq::PointSumSelector<LR, ET, COMPRESS, PLO, FIGURE> Selector;
+
+public:
+   typedef typename Base::Storage Storage;
+   typedef typename Base::FigureOfMerit FigureOfMerit;
+   typedef typename LatticeTraits<LR>::GeneratingVector GeneratingVector;
+
+   Eval(
+         Storage storage,
+         Dimension dimension,
+         FigureOfMerit figure,
+         GeneratingVector genVec
+         ):
+      Base(std::move(storage), dimension, std::move(figure), typename Base::Traits(std::move(genVec)))
+   {}
+
+   Eval(Eval&& other):
+      Base(std::move(other))
+   {}
+
+   virtual ~Eval() {}
+
+   virtual void execute()
+   {
+      if (not executePointSum(std::integral_constant<bool, Selector::Enabled>()))
+         Base::execute();
+   }
+
+private:
+   template <class SELECTOR = Selector>
+   bool executePointSum(std::true_type)
+   {
+      typedef typename SELECTOR::PointSum PointSum;
+
+      if (not PointSum::supports(this->figureOfMerit()))
+         return false;
+
+      const auto& genVec = this->traits().genVec;
+      if (this->dimension() > genVec.size())
+         throw std::runtime_error("dimension > generating vector size");
+
+      PointSum pointSum(this->storage(), this->figureOfMerit());
+      std::vector<typename PointSum::LatDef> lats{createLatDef(
+            this->storage().sizeParam(),
+            GeneratingVector(genVec.begin(), genVec.begin() + this->dimension()))};
+      this->setObserverTotalDim(1);
+
+      auto fseq = this->filters().apply(pointSum.meritSeq(lats));
+      const auto itmin = this->minElement()(fseq.begin(), fseq.end(), this->minObserver().maxAcceptedCount(), this->verbose());
+      this->selectBestLattice(*itmin.base().base(), *itmin, false);
+      return true;
+   }
+
+   template <class SELECTOR = Selector>
+   bool executePointSum(std::false_type)
+   { return false; }
+};
+
 TASK_FOR_ALL(TASK_EXTERN_TEMPLATE, CBCBasedSearch, Eval);
+TASK_FOR_ALL(TASK_EXTERN_TEMPLATE1, Eval, NOTAG);
 
 }}
 
@@ -37,6 +37,10 @@
    func(__VA_ARGS__,LatticeType::ORDINARY, EmbeddingType::MULTILEVEL, Compress::NONE, PerLevelOrder::CYCLIC); \
    func(__VA_ARGS__,LatticeType::ORDINARY, EmbeddingType::MULTILEVEL, Compress::SYMMETRIC, PerLevelOrder::CYCLIC)
 
+#define TASK_ADD_ARG_PARAMETERS_LATTICE_ORDINARY_UNILEVEL(func, ...) \
+   func(__VA_ARGS__,LatticeType::ORDINARY, EmbeddingType::UNILEVEL, Compress::NONE, PerLevelOrder::BASIC); \
+   func(__VA_ARGS__,LatticeType::ORDINARY, EmbeddingType::UNILEVEL, Compress::SYMMETRIC, PerLevelOrder::BASIC)
+
 #define TASK_ADD_ARG_PARAMETERS_LATTICE_POLYNOMIAL(func, ...) \
    func(__VA_ARGS__,LatticeType::POLYNOMIAL, EmbeddingType::UNILEVEL, Compress::NONE, PerLevelOrder::BASIC); \
    func(__VA_ARGS__,LatticeType::POLYNOMIAL, EmbeddingType::MULTILEVEL, Compress::NONE, PerLevelOrder::BASIC); \
@@ -98,6 +102,13 @@
 		   TASK_ADD_COORDSYM_FIGURE, \
 		   func, __VA_ARGS__)
 
+#define TASK_FOR_ALL_COORDSYM_LATTICE_ORDINARY_UNILEVEL(func, ...) \
+   TASK_INDIRECT( \
+		   TASK_ADD_ARG_KERNEL_LATTICE_ORDINARY, \
+		   TASK_ADD_ARG_PARAMETERS_LATTICE_ORDINARY_UNILEVEL, \
+		   TASK_ADD_COORDSYM_FIGURE, \
+		   func, __VA_ARGS__)
+
 #define TASK_FOR_ALL_COORDSYM_LATTICE_POLYNOMIAL(func, ...) \
    TASK_INDIRECT( \
          TASK_ADD_ARG_KERNEL_LATTICE_POLYNOMIAL, \
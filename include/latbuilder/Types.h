@@ -26,6 +26,7 @@
 #include <boost/numeric/ublas/vector.hpp>
 #include <NTL/GF2X.h>
 #include "latbuilder/ntlwrap.h"
+#include "latbuilder/OutOfCore.h"
 #include "netbuilder/GeneratingMatrix.h"
 
 
@@ -42,8 +43,9 @@ const int LENGTH_UINTEGER = 64;
 /// Scalar floating-point type.
 typedef double Real;
 
-/// Vector of floating-point values.
-typedef boost::numeric::ublas::vector<Real> RealVector;
+/// Vector of floating-point values (stored out of core when large, see OutOfCore).
+typedef boost::numeric::ublas::vector<Real,
+        boost::numeric::ublas::unbounded_array<Real, MappedAllocator<Real>>> RealVector;
 
 /// Scalar integer type for level of embedding.
 typedef RealVector::size_type Level;
@@ -93,6 +93,27 @@ T modularPow(T base, uInteger exponent, T modulus)
    return result;
 }
 
+/**
+ * Returns \f$a b \bmod n\f$ without overflow, for \f$a, b < n\f$.
+ */
+inline uInteger mulMod(uInteger a, uInteger b, uInteger n)
+{
+#ifdef __SIZEOF_INT128__
+   return static_cast<uInteger>(static_cast<unsigned __int128>(a) * b % n);
+#else
+   if ((a | b) >> 32 == 0)
+      return a * b % n;
+   uInteger result = 0;
+   while (b) {
+      if (b & 1)
+         result = result >= n - a ? result - (n - a) : result + a;
+      a = a >= n - a ? a - (n - a) : a + a;
+      b >>= 1;
+   }
+   return result;
+#endif
+}
+
 /**
  * Prime factorization using the naive "trial division" algorithm.
  *
@@ -26,9 +26,12 @@
 #include "latbuilder/ProjDepMerit/Base.h"
 #include "latbuilder/Functor/AllOf.h"
 #include "latbuilder/Storage.h"
+#include "latbuilder/Parallel.h"
 
 #include <boost/signals2.hpp>
 
+#include <exception>
+#include <limits>
 #include <vector>
 #include <memory>
 
@@ -74,6 +77,10 @@ class WeightedFigureOfMeritEvaluator;
  *
  * \note The WeightedFigureOfMeritEvaluator object returned by the evaluator()
  * function produces a <strong>square</strong> merit value.
+ *
+ * \note If enabled with setParallelProjections(), the evaluator computes the
+ * projection-dependent merit values of several projections in parallel, so
+ * the projection-dependent evaluator must be safe to call concurrently.
  */
 template <class PROJDEP, template <typename> class ACC>
 class WeightedFigureOfMerit : public FigureOfMerit
@@ -229,6 +236,9 @@ public:
          MeritValue initialValue
          ) const
    {
+      if (parallelProjections() and not inParallel())
+         return evaluateInBatches(lat, projections, std::move(initialValue));
+
    //#define DEBUG
       using namespace LatticeTester;
 #ifdef DEBUG
@@ -292,6 +302,141 @@ public:
    }
 
 private:
+   /**
+    * Same as operator(), but the projections are evaluated in parallel.
+    */
+   template <class CSETS>
+   MeritValue evaluateInBatches(
+         const LatDef<LR, ET>& lat,
+         const CSETS& projections,
+         MeritValue initialValue
+         ) const
+   {
+      using namespace LatticeTester;
+#ifdef DEBUG
+      using TextStream::operator<<;
+      std::cout << "computing merit for lattice " << lat << std::endl;
+      size_t nproj = 0;
+#endif
+
+      auto acc = m_figure.accumulator(std::move(initialValue));
+
+      // divide q by the normType of the kernel
+      const Real power = m_figure.normType() / m_figure.projDepMerit().power();
+
+      // The projections are evaluated by batches, in parallel, and their
+      // contributions are accumulated in the order of the projections, so that
+      // the merit value does not depend on the number of threads and the
+      // progress signal is emitted after each projection, as in a sequential
+      // loop.  On abort, at most the rest of the current batch was evaluated
+      // needlessly.
+      const size_t batchSize = ProjectionsPerThread * static_cast<size_t>(maxThreads());
+      std::vector<Coordinates> batch;
+      std::vector<Real> weights;
+      std::vector<MeritValue> merits;
+      batch.reserve(batchSize);
+      weights.reserve(batchSize);
+
+      auto cit = projections.begin ();
+      bool aborted = false;
+      while (not aborted and cit != projections.end ()) {
+
+         batch.clear();
+         weights.clear();
+
+         for (; cit != projections.end () and batch.size() < batchSize; ++cit) {
+
+            const Coordinates& proj = *cit;
+
+            if (*proj.rbegin() >= lat.dimension())
+               throw std::invalid_argument("WeightedFigureOfMerit: no such projection");
+
+            Real weight = m_figure.weights().getWeight(proj);
+
+            if (weight == 0.0) {
+#ifdef DEBUG
+               std::cout << "  skipping projection: " << proj << std::endl;
+#endif
+               continue;
+            }
+
+            batch.push_back(proj);
+            weights.push_back(weight);
+         }
+
+         evaluate(lat, batch, merits);
+
+         for (size_t i = 0; i < batch.size(); i++) {
+
+#ifdef DEBUG
+            std::cout << "  processing projection: " << batch[i] << std::endl;
+            std::cout << "    weight:    " << weights[i] << std::endl;
+            std::cout << "    merit:     " << merits[i] << std::endl;
+            std::cout << "    weighted:  " << (weights[i] * merits[i]) << std::endl;
+#endif
+
+            acc.accumulate(weights[i], merits[i], power);
+
+            if (!onProgress()(acc.value())) {
+               acc.accumulate(std::numeric_limits<Real>::infinity(), merits[i], power);
+               onAbort()(lat);
+#ifdef DEBUG
+               std::cout << "    aborting" << std::endl;
+#endif
+               aborted = true;
+               break;
+            }
+
+#ifdef DEBUG
+            ++nproj;
+#endif
+         }
+      }
+
+#ifdef DEBUG
+      std::cout << "  projections considered: " << nproj << std::endl;
+      std::cout << "  final merit: " << acc.value() << std::endl;
+#endif
+
+      return acc.value();
+   }
+
+   /**
+    * Number of projections evaluated by each thread in a batch.
+    */
+   static constexpr size_t ProjectionsPerThread = 4;
+
+   /**
+    * Stores into \c merits the values of the projection-dependent figure of
+    * merit of \c lat for the projections in \c projections, computed in
+    * parallel.
+    */
+   void evaluate(
+         const LatDef<LR, ET>& lat,
+         const std::vector<LatticeTester::Coordinates>& projections,
+         std::vector<MeritValue>& merits
+         ) const
+   {
+      merits.resize(projections.size());
+      const long size = static_cast<long>(projections.size());
+
+      // exceptions cannot leave a parallel region: the first one is rethrown after it
+      std::exception_ptr error;
+      #pragma omp parallel for schedule(dynamic, 1) if(size > 1)
+      for (long i = 0; i < size; i++) {
+         try {
+            merits[i] = m_eval(lat, projections[i]);
+         }
+         catch (...) {
+            #pragma omp critical
+            if (!error)
+               error = std::current_exception();
+         }
+      }
+      if (error)
+         std::rethrow_exception(error);
+   }
+
    std::unique_ptr<OnProgress> m_onProgress;
    std::unique_ptr<OnAbort> m_onAbort;
 
@@ -29,12 +29,33 @@
 #endif
 
 #include <stdexcept>
+#include <climits>
+#include <string>
 #include <complex>
+#include <new>
+#include <mutex>
+#include <utility>
+#include <vector>
 #include <fftw3.h>
 
+#include "latbuilder/OutOfCore.h"
+
+
+/**
+ * Returns the mutex that serializes the FFTW planner.
+ * Only the execution of plans is thread-safe in FFTW; the creation and
+ * destruction of plans, and the number of threads used by the planner, must
+ * not be accessed concurrently.
+ */
+inline std::mutex& fftw_planner_mutex()
+{
+   static std::mutex mutex;
+   return mutex;
+}
 
 /**
- * Wrapper for a subset of FFTW: FFT's for real functions in one dimension.
+ * Wrapper for a subset of FFTW: FFT's for real functions in one or several
+ * dimensions.
  */
 template <typename T>
 struct fftw
@@ -64,9 +85,14 @@ struct fftw
       ~allocator() throw() { }
 
       pointer allocate(size_type n, const void* = 0)
-      { return static_cast<Tp*>(c_api::malloc(n * sizeof(Tp))); }
+      {
+         Tp* p = static_cast<Tp*>(malloc_buffer(n * sizeof(Tp)));
+         if (!p and n > 0)
+            throw std::bad_alloc();
+         return p;
+      }
 
-      void deallocate(pointer p, size_type) { c_api::free(p); }
+      void deallocate(pointer p, size_type n) { free_buffer(p, n * sizeof(Tp)); }
 
       constexpr size_type max_size() const throw() { return size_t(-1) / sizeof(Tp); }
 
@@ -78,6 +104,32 @@ struct fftw
    /// Low-level wrapper for the C API of FFTW.
    struct c_api;
 
+   /**
+    * Allocates a buffer of \c bytes bytes with FFTW's allocation function or,
+    * for large buffers when out-of-core storage is enabled, in a mapped file
+    * (see LatBuilder::OutOfCore), whose pages are suitably aligned.
+    *
+    * \return A pointer to the buffer, or \c nullptr if it cannot be allocated.
+    */
+   static void* malloc_buffer(size_t bytes)
+   {
+      if (bytes >= LatBuilder::OutOfCore::MinMappedBytes) {
+         if (void* p = LatBuilder::OutOfCore::allocate(bytes))
+            return p;
+      }
+      return c_api::malloc(bytes);
+   }
+
+   /// Releases a buffer of \c bytes bytes allocated by malloc_buffer().
+   static void free_buffer(void* p, size_t bytes)
+   {
+      if (!p)
+         return;
+      if (bytes >= LatBuilder::OutOfCore::MinMappedBytes and LatBuilder::OutOfCore::deallocate(p, bytes))
+         return;
+      c_api::free(p);
+   }
+
    /// Real number.
    typedef T real;
 
@@ -101,6 +153,17 @@ struct fftw
    typedef std::vector<complex, allocator<complex> > complex_vector;
 #endif
 
+   /**
+    * Returns \c n as an \c int, the type of the sizes in the FFTW interface.
+    * Throws \c std::length_error if \c n is larger than \c INT_MAX.
+    */
+   static int int_size(size_t n, const char* where)
+   {
+      if (n > static_cast<size_t>(INT_MAX))
+         throw std::length_error(std::string(where) + ": size exceeds INT_MAX");
+      return static_cast<int>(n);
+   }
+
    /**
     * Computes the real-to-complex Fourier transform of \c v into \c result.
     * The size of the transform is that of the real component.
@@ -112,14 +175,24 @@ struct fftw
    {
       if (result.size() < fft_size(v))
          throw std::invalid_argument("fftw::fft(): result must have size v.size() / 2 + 1");
-      // the transform is performed out-of-place, hence the const_cast is safe
-      typename c_api::plan p = c_api::plan_dft_r2c_1d(
-            static_cast<int>(v.size()),
-            const_cast<typename real_vector::value_type*>(&v[0]),
-            &result[0],
-            FFTW_ESTIMATE);
+      const int n = int_size(v.size(), "fftw::fft()");
+      typename c_api::plan p;
+      {
+         std::lock_guard<std::mutex> lock(fftw_planner_mutex());
+         // the transform is performed out-of-place, hence the const_cast is safe
+         p = c_api::plan_dft_r2c_1d(
+               n,
+               const_cast<typename real_vector::value_type*>(&v[0]),
+               &result[0],
+               FFTW_ESTIMATE);
+      }
+      if (!p)
+         throw std::runtime_error("fftw::fft(): cannot create plan");
       c_api::execute(p);
-      c_api::destroy_plan(p);
+      {
+         std::lock_guard<std::mutex> lock(fftw_planner_mutex());
+         c_api::destroy_plan(p);
+      }
       return result;
    }
 
@@ -161,14 +234,24 @@ struct fftw
    {
       if (v.size() < fft_size(result))
          throw std::invalid_argument("fftw::ifft(): v must have size result.size() / 2 + 1");
-      // the transform is performed out-of-place, hence the const_cast is safe
-      typename c_api::plan p = c_api::plan_dft_c2r_1d(
-            static_cast<int>(result.size()),
-            const_cast<typename complex_vector::value_type*>(&v[0]),
-            &result[0],
-            FFTW_ESTIMATE);
+      const int n = int_size(result.size(), "fftw::ifft()");
+      typename c_api::plan p;
+      {
+         std::lock_guard<std::mutex> lock(fftw_planner_mutex());
+         // the transform is performed out-of-place, hence the const_cast is safe
+         p = c_api::plan_dft_c2r_1d(
+               n,
+               const_cast<typename complex_vector::value_type*>(&v[0]),
+               &result[0],
+               FFTW_ESTIMATE);
+      }
+      if (!p)
+         throw std::runtime_error("fftw::ifft(): cannot create plan");
       c_api::execute(p);
-      c_api::destroy_plan(p);
+      {
+         std::lock_guard<std::mutex> lock(fftw_planner_mutex());
+         c_api::destroy_plan(p);
+      }
       if (normalize) {
          real norm = static_cast<real>(1.0 / result.size());
          for (typename real_vector::iterator it = result.begin(); it != result.end(); ++it)
@@ -198,6 +281,368 @@ struct fftw
       ifft(v, fv, normalize);
       return fv;
    }
+
+#ifdef FFTWXX_USE_THREADS
+   /**
+    * Initializes the FFTW threads library.
+    * FFTW requires this to be done once, before any other call to FFTW, so
+    * it must be called at program startup, before any thread is created.
+    * Returns \c true if multithreaded plans can be created.
+    */
+   static bool init_threads()
+   {
+      if (!threads_flag())
+         threads_flag() = c_api::init_threads();
+      return threads_flag();
+   }
+
+   /**
+    * Returns \c true if init_threads() has been called successfully.
+    * Otherwise, all plans are single-threaded.
+    */
+   static bool threads_initialized()
+   { return threads_flag(); }
+
+private:
+   static bool& threads_flag()
+   {
+      static bool initialized = false;
+      return initialized;
+   }
+
+public:
+#endif
+
+   /**
+    * In-place real-to-complex and complex-to-real transforms of a fixed size.
+    *
+    * A single aligned buffer of \c size() / 2 + 1 complex numbers is allocated
+    * at construction, together with the forward and backward plans that act
+    * on it.  The real data occupy the first \c size() elements of the buffer
+    * viewed as an array of real numbers.  Repeated transforms thus require
+    * neither memory allocation nor planning.
+    *
+    * Copying an instance creates a new buffer and new plans of the same size;
+    * the contents of the buffer are not copied.
+    *
+    * If FFTWXX_USE_THREADS is defined (and the program is linked with the
+    * FFTW threads library), the plans can be created to split each transform
+    * across several threads.
+    */
+   class inplace_transform
+   {
+   public:
+      /**
+       * Constructor.
+       *
+       * \param n          Size of the transform (number of real elements).
+       * \param nthreads   Number of threads used by each transform; ignored
+       *                   unless FFTWXX_USE_THREADS is defined.
+       */
+      explicit inplace_transform(size_t n, int nthreads = 1):
+         m_size(checked_size(n)),
+         m_threads(nthreads),
+         m_data(static_cast<complex*>(malloc_buffer(complex_size(n) * sizeof(complex)))),
+         m_forward(nullptr),
+         m_backward(nullptr)
+      {
+         if (!m_data)
+            throw std::bad_alloc();
+         {
+            std::lock_guard<std::mutex> lock(fftw_planner_mutex());
+#ifdef FFTWXX_USE_THREADS
+            if (threads_initialized())
+               c_api::plan_with_nthreads(m_threads);
+#endif
+            // the arrays are not overwritten when planning with FFTW_ESTIMATE
+            m_forward = c_api::plan_dft_r2c_1d(static_cast<int>(m_size), real_data(), m_data, FFTW_ESTIMATE);
+            m_backward = c_api::plan_dft_c2r_1d(static_cast<int>(m_size), m_data, real_data(), FFTW_ESTIMATE);
+#ifdef FFTWXX_USE_THREADS
+            if (threads_initialized())
+               c_api::plan_with_nthreads(1);
+#endif
+         }
+         if (!m_forward or !m_backward) {
+            release();
+            throw std::runtime_error("fftw::inplace_transform(): cannot create plans");
+         }
+      }
+
+      inplace_transform(const inplace_transform& other):
+         inplace_transform(other.size(), other.threads())
+      {}
+
+      inplace_transform(inplace_transform&& other):
+         m_size(other.m_size),
+         m_threads(other.m_threads),
+         m_data(other.m_data),
+         m_forward(other.m_forward),
+         m_backward(other.m_backward)
+      {
+         other.m_data = nullptr;
+         other.m_forward = nullptr;
+         other.m_backward = nullptr;
+      }
+
+      inplace_transform& operator=(inplace_transform other)
+      {
+         std::swap(m_size, other.m_size);
+         std::swap(m_threads, other.m_threads);
+         std::swap(m_data, other.m_data);
+         std::swap(m_forward, other.m_forward);
+         std::swap(m_backward, other.m_backward);
+         return *this;
+      }
+
+      ~inplace_transform()
+      { release(); }
+
+      /// Returns the size of the transform.
+      size_t size() const
+      { return m_size; }
+
+      /// Returns the number of threads used by each transform.
+      int threads() const
+      { return m_threads; }
+
+      /// Returns the number of complex elements in the transformed buffer.
+      static size_t complex_size(size_t n)
+      { return n / 2 + 1; }
+
+      /// Returns the number of complex elements in the transformed buffer.
+      size_t complex_size() const
+      { return complex_size(m_size); }
+
+      /// Returns a pointer to the buffer seen as \c size() real numbers.
+      real* real_data()
+      { return reinterpret_cast<real*>(m_data); }
+
+      /// Returns a pointer to the buffer seen as \c size() real numbers.
+      const real* real_data() const
+      { return reinterpret_cast<const real*>(m_data); }
+
+      /// Returns a pointer to the buffer seen as \c complex_size() complex numbers.
+      complex* complex_data()
+      { return m_data; }
+
+      /// Returns a pointer to the buffer seen as \c complex_size() complex numbers.
+      const complex* complex_data() const
+      { return m_data; }
+
+      /// Replaces the real data in the buffer by their Fourier transform.
+      void forward()
+      { c_api::execute(m_forward); }
+
+      /**
+       * Replaces the complex data in the buffer by their unnormalized inverse
+       * Fourier transform; the real results must be divided by \c size().
+       */
+      void backward()
+      { c_api::execute(m_backward); }
+
+   private:
+      /// Returns \c n if it is a valid transform size; throws otherwise.
+      static size_t checked_size(size_t n)
+      {
+         if (n == 0)
+            throw std::invalid_argument("fftw::inplace_transform(): size must be positive");
+         int_size(n, "fftw::inplace_transform()");
+         return n;
+      }
+
+      void release()
+      {
+         if (m_forward or m_backward) {
+            std::lock_guard<std::mutex> lock(fftw_planner_mutex());
+            if (m_forward)
+               c_api::destroy_plan(m_forward);
+            if (m_backward)
+               c_api::destroy_plan(m_backward);
+         }
+         free_buffer(m_data, complex_size() * sizeof(complex));
+         m_forward = nullptr;
+         m_backward = nullptr;
+         m_data = nullptr;
+      }
+
+      size_t m_size;
+      int m_threads;
+      complex* m_data;
+      typename c_api::plan m_forward;
+      typename c_api::plan m_backward;
+   };
+
+   /**
+    * Out-of-place multidimensional real-to-complex and complex-to-real
+    * transforms of a fixed shape.
+    *
+    * The real data are stored in row-major order, the last dimension varying
+    * fastest.  As in one dimension, only the first half (plus one) of the
+    * last dimension is stored in the transformed buffer.  Both buffers and
+    * both plans are allocated at construction, as in inplace_transform.  The
+    * backward transform overwrites the contents of the complex buffer.
+    */
+   class multi_transform
+   {
+   public:
+      /**
+       * Constructor.
+       *
+       * \param shape      Size of the transform along each dimension.
+       * \param nthreads   Number of threads used by each transform; ignored
+       *                   unless FFTWXX_USE_THREADS is defined.
+       */
+      explicit multi_transform(std::vector<int> shape, int nthreads = 1):
+         m_shape(std::move(shape)),
+         m_threads(nthreads),
+         m_size(1),
+         m_complex_size(1),
+         m_real(nullptr),
+         m_complex(nullptr),
+         m_forward(nullptr),
+         m_backward(nullptr)
+      {
+         if (m_shape.empty())
+            throw std::invalid_argument("fftw::multi_transform(): at least one dimension is required");
+         for (size_t i = 0; i < m_shape.size(); i++) {
+            if (m_shape[i] <= 0)
+               throw std::invalid_argument("fftw::multi_transform(): sizes must be positive");
+            m_size *= m_shape[i];
+            m_complex_size *= i + 1 < m_shape.size() ? m_shape[i] : m_shape[i] / 2 + 1;
+         }
+         m_real = static_cast<real*>(malloc_buffer(m_size * sizeof(real)));
+         m_complex = static_cast<complex*>(malloc_buffer(m_complex_size * sizeof(complex)));
+         if (!m_real or !m_complex) {
+            free_buffer(m_real, m_size * sizeof(real));
+            free_buffer(m_complex, m_complex_size * sizeof(complex));
+            throw std::bad_alloc();
+         }
+         const int rank = static_cast<int>(m_shape.size());
+         {
+            std::lock_guard<std::mutex> lock(fftw_planner_mutex());
+#ifdef FFTWXX_USE_THREADS
+            if (threads_initialized())
+               c_api::plan_with_nthreads(m_threads);
+#endif
+            m_forward = c_api::plan_dft_r2c(rank, &m_shape[0], m_real, m_complex, FFTW_ESTIMATE);
+            m_backward = c_api::plan_dft_c2r(rank, &m_shape[0], m_complex, m_real, FFTW_ESTIMATE);
+#ifdef FFTWXX_USE_THREADS
+            if (threads_initialized())
+               c_api::plan_with_nthreads(1);
+#endif
+         }
+         if (!m_forward or !m_backward) {
+            release();
+            throw std::runtime_error("fftw::multi_transform(): cannot create plans");
+         }
+      }
+
+      multi_transform(const multi_transform& other):
+         multi_transform(other.shape(), other.threads())
+      {}
+
+      multi_transform(multi_transform&& other):
+         m_shape(std::move(other.m_shape)),
+         m_threads(other.m_threads),
+         m_size(other.m_size),
+         m_complex_size(other.m_complex_size),
+         m_real(other.m_real),
+         m_complex(other.m_complex),
+         m_forward(other.m_forward),
+         m_backward(other.m_backward)
+      {
+         other.m_real = nullptr;
+         other.m_complex = nullptr;
+         other.m_forward = nullptr;
+         other.m_backward = nullptr;
+      }
+
+      multi_transform& operator=(multi_transform other)
+      {
+         std::swap(m_shape, other.m_shape);
+         std::swap(m_threads, other.m_threads);
+         std::swap(m_size, other.m_size);
+         std::swap(m_complex_size, other.m_complex_size);
+         std::swap(m_real, other.m_real);
+         std::swap(m_complex, other.m_complex);
+         std::swap(m_forward, other.m_forward);
+         std::swap(m_backward, other.m_backward);
+         return *this;
+      }
+
+      ~multi_transform()
+      { release(); }
+
+      /// Returns the size of the transform along each dimension.
+      const std::vector<int>& shape() const
+      { return m_shape; }
+
+      /// Returns the number of threads used by each transform.
+      int threads() const
+      { return m_threads; }
+
+      /// Returns the number of real elements.
+      size_t size() const
+      { return m_size; }
+
+      /// Returns the number of complex elements in the transformed buffer.
+      size_t complex_size() const
+      { return m_complex_size; }
+
+      /// Returns a pointer to the buffer of \c size() real numbers.
+      real* real_data()
+      { return m_real; }
+
+      /// Returns a pointer to the buffer of \c size() real numbers.
+      const real* real_data() const
+      { return m_real; }
+
+      /// Returns a pointer to the buffer of \c complex_size() complex numbers.
+      complex* complex_data()
+      { return m_complex; }
+
+      /// Returns a pointer to the buffer of \c complex_size() complex numbers.
+      const complex* complex_data() const
+      { return m_complex; }
+
+      /// Transforms the real buffer into the complex buffer.
+      void forward()
+      { c_api::execute(m_forward); }
+
+      /**
+       * Transforms the complex buffer into the real buffer, without
+       * normalization; the real results must be divided by \c size().
+       */
+      void backward()
+      { c_api::execute(m_backward); }
+
+   private:
+      void release()
+      {
+         if (m_forward or m_backward) {
+            std::lock_guard<std::mutex> lock(fftw_planner_mutex());
+            if (m_forward)
+               c_api::destroy_plan(m_forward);
+            if (m_backward)
+               c_api::destroy_plan(m_backward);
+         }
+         free_buffer(m_real, m_size * sizeof(real));
+         free_buffer(m_complex, m_complex_size * sizeof(complex));
+         m_forward = nullptr;
+         m_backward = nullptr;
+         m_real = nullptr;
+         m_complex = nullptr;
+      }
+
+      std::vector<int> m_shape;
+      int m_threads;
+      size_t m_size;
+      size_t m_complex_size;
+      real* m_real;
+      complex* m_complex;
+      typename c_api::plan m_forward;
+      typename c_api::plan m_backward;
+   };
 };
 
 /**
@@ -224,11 +669,25 @@ struct fftw<float>::c_api
    static plan plan_dft_c2r_1d(int n, complex *in, real *out, unsigned flags)
    { return fftwf_plan_dft_c2r_1d(n, reinterpret_cast<fftwf_complex*>(in), out, flags); }
 
+   static plan plan_dft_r2c(int rank, const int *n, real *in, complex *out, unsigned flags)
+   { return fftwf_plan_dft_r2c(rank, n, in, reinterpret_cast<fftwf_complex*>(out), flags); }
+
+   static plan plan_dft_c2r(int rank, const int *n, complex *in, real *out, unsigned flags)
+   { return fftwf_plan_dft_c2r(rank, n, reinterpret_cast<fftwf_complex*>(in), out, flags); }
+
    static void destroy_plan(plan p)
    { fftwf_destroy_plan(p); }
 
    static void execute(const plan p)
    { return fftwf_execute(p); }
+
+#ifdef FFTWXX_USE_THREADS
+   static bool init_threads()
+   { return fftwf_init_threads() != 0; }
+
+   static void plan_with_nthreads(int nthreads)
+   { fftwf_plan_with_nthreads(nthreads); }
+#endif
 };
 
 /**
@@ -255,11 +714,25 @@ struct fftw<double>::c_api
    static plan plan_dft_c2r_1d(int n, complex *in, real *out, unsigned flags)
    { return fftw_plan_dft_c2r_1d(n, reinterpret_cast<fftw_complex*>(in), out, flags); }
 
+   static plan plan_dft_r2c(int rank, const int *n, real *in, complex *out, unsigned flags)
+   { return fftw_plan_dft_r2c(rank, n, in, reinterpret_cast<fftw_complex*>(out), flags); }
+
+   static plan plan_dft_c2r(int rank, const int *n, complex *in, real *out, unsigned flags)
+   { return fftw_plan_dft_c2r(rank, n, reinterpret_cast<fftw_complex*>(in), out, flags); }
+
    static void destroy_plan(plan p)
    { fftw_destroy_plan(p); }
 
    static void execute(const plan p)
    { return fftw_execute(p); }
+
+#ifdef FFTWXX_USE_THREADS
+   static bool init_threads()
+   { return fftw_init_threads() != 0; }
+
+   static void plan_with_nthreads(int nthreads)
+   { fftw_plan_with_nthreads(nthreads); }
+#endif
 };
 
 
@@ -19,13 +19,21 @@
 
 #include "netbuilder/FigureOfMerit/FigureOfMerit.h"
 #include "netbuilder/FigureOfMerit/LevelCombiner.h"
+#include "netbuilder/FigureOfMerit/ProjectionTValueCache.h"
+
+#include <algorithm>
+#include <chrono>
 
 namespace NetBuilder { namespace FigureOfMerit {
 
 using LatBuilder::Functor::AllOf;
 
 /** 
- * Aggregation of figures of merit computed in a specific order.
+ * Aggregation of figures of merit.
+ * The evaluator measures the cost and the rejection rate of each figure during the search and evaluates first
+ * the figures which reject the most nets per unit of time. The merits are aggregated in the order of the figures,
+ * so that the merit does not depend on the evaluation order.
+ * The figures share the t-values of the projections of the net being evaluated (see ProjectionTValueCache).
  */ 
 class CombinedFigureOfMerit : public CBCFigureOfMerit{
 
@@ -113,11 +121,19 @@ class CombinedFigureOfMerit : public CBCFigureOfMerit{
                 CombinedFigureOfMeritEvaluator(CombinedFigureOfMerit* figure):
                     m_figure(figure),
                     m_oldMerits(figure->size(),0),
-                    m_newMerits(figure->size(),0)
+                    m_newMerits(figure->size(),0),
+                    m_costs(figure->size(),0),
+                    m_numEvaluations(figure->size(),0),
+                    m_numRejections(figure->size(),0)
                 {
                     for(unsigned int i = 0; i < m_figure->size(); ++i)
                     {
                         m_evaluators.push_back((m_figure->pointerToFigure(i)->evaluator()));
+                        m_order.push_back(i);
+                    }
+                    if (m_figure->size() > 1) // the figures share the t-values of the projections of each net
+                    {
+                        setTValueCache(&m_tValueCache);
                     }
                 };
 
@@ -133,28 +149,35 @@ class CombinedFigureOfMerit : public CBCFigureOfMerit{
                 {
                     auto acc = m_figure->accumulator(0); // create the accumulator from the initial value
 
+                    m_tValueCache.clear(); // the t-values of the previous net are not relevant
+
+                    const std::vector<Real> weights = m_figure->weights();
                     Real weight; // weight of the figure currently evaluated
 
                     // capture used to determine whether the computation should be aborted is early abortion is activated
                     auto goOn = [this, &acc, &weight] (MeritValue value) -> bool { return this->onProgress()(acc.tryAccumulate(weight, value, this->m_figure->expNorm())) ;} ;
 
-
-                    for(unsigned int i = 0; i < m_figure->size(); ++i)
+                    for(unsigned int i : m_order) // figures in the order of the scheduling
                     {
                         if (verbose>0)
                         {
                             std::cout << "Computing for figure num " << i  << "..." << std::endl;
                         }
 
-                        weight = m_figure->weights()[i];
+                        weight = weights[i];
 
                         if (weight != 0.0)
                         {
                             auto goOnConnection = m_evaluators[i]->onProgress().connect(goOn); // connect the closure
 
+                            const auto start = std::chrono::steady_clock::now();
+
                             m_newMerits[i] = (*m_evaluators[i])(net, dimension, 0, verbose-1); // compute the merit
 
-                            acc.accumulate(m_figure->weights()[i], m_newMerits[i], m_figure->expNorm()) ; // accumulate the merit
+                            m_costs[i] += std::chrono::duration<Real>(std::chrono::steady_clock::now() - start).count();
+                            ++m_numEvaluations[i];
+
+                            acc.accumulate(weight, m_newMerits[i], m_figure->expNorm()) ; // accumulate the merit
 
                             goOnConnection.disconnect(); // disconnect the closure
 
@@ -165,9 +188,11 @@ class CombinedFigureOfMerit : public CBCFigureOfMerit{
 
                             if (!onProgress()(acc.value())) // if someone is listening, may tell that the computation is useless
                             {
+                                ++m_numRejections[i];
+                                schedule();
                                 acc.accumulate(weight, std::numeric_limits<Real>::infinity(), m_figure->expNorm()); // set the merit to infinity
                                 onAbort()(net); // abort the computation
-                                break;
+                                return acc.value();
                             }
                         }
                         else
@@ -178,9 +203,33 @@ class CombinedFigureOfMerit : public CBCFigureOfMerit{
                             }
                         }
                     }
+                    schedule();
+
+                    // accumulate again in the order of the figures, so that the merit does not depend on the scheduling
+                    acc.set(0);
+                    for(unsigned int i = 0; i < m_figure->size(); ++i)
+                    {
+                        if (weights[i] != 0.0)
+                        {
+                            acc.accumulate(weights[i], m_newMerits[i], m_figure->expNorm());
+                        }
+                    }
                     return acc.value();
                 }
 
+                /**
+                 * Sets the cache of the t-values of projections shared by the evaluators of the figures, 
+                 * for instance the cache of an enclosing combined figure of merit.
+                 * @param cache Pointer to the cache, or \c nullptr to compute all the t-values.
+                 */
+                virtual void setTValueCache(ProjectionTValueCache* cache) override
+                {
+                    for(auto& eval : m_evaluators)
+                    {
+                        eval->setTValueCache(cache);
+                    }
+                }
+
                 /**     
                  * Resets the evaluator and prepare it to evaluate a new net.
                  */ 
@@ -222,11 +271,41 @@ class CombinedFigureOfMerit : public CBCFigureOfMerit{
                 }
 
             private:
+
+                /** 
+                 * Sorts the figures by decreasing number of rejections per unit of time, estimated from the previous evaluations,
+                 * so that the figures which reject nets cheaply are evaluated first. The rejection rate of a figure
+                 * is estimated on the nets which were not rejected by the figures evaluated before it.
+                 * The figures which were never evaluated are kept first.
+                 */ 
+                void schedule()
+                {
+                    std::vector<Real> scores(m_figure->size());
+                    for(unsigned int i = 0; i < m_figure->size(); ++i)
+                    {
+                        if (m_numEvaluations[i] == 0 || m_costs[i] <= 0)
+                        {
+                            scores[i] = std::numeric_limits<Real>::infinity();
+                        }
+                        else
+                        {
+                            const Real rejectionRate = (m_numRejections[i] + 1.0) / (m_numEvaluations[i] + 2.0);
+                            scores[i] = rejectionRate * m_numEvaluations[i] / m_costs[i];
+                        }
+                    }
+                    std::stable_sort(m_order.begin(), m_order.end(), [&scores](unsigned int a, unsigned int b) { return scores[a] > scores[b]; });
+                }
+
                 CombinedFigureOfMerit* m_figure; // pointer to the figure
                 std::vector<std::unique_ptr<CBCFigureOfMeritEvaluator>> m_evaluators; // evaluators
                 std::vector<Real> m_oldMerits; // merits for the best net of the previous dimension
                 std::vector<Real> m_bestNewMerits; // best merits for the best net so far for the current dimension
                 std::vector<Real> m_newMerits; // merits of the latest evaluated net 
+                std::vector<unsigned int> m_order; // evaluation order of the figures
+                std::vector<Real> m_costs; // total time spent evaluating each figure, in seconds
+                std::vector<unsigned long> m_numEvaluations; // number of evaluations of each figure
+                std::vector<unsigned long> m_numRejections; // number of nets rejected after the evaluation of each figure
+                ProjectionTValueCache m_tValueCache; // t-values of the projections of the net being evaluated
 
         };
 
@@ -19,17 +19,24 @@
 
 #include "netbuilder/FigureOfMerit/FigureOfMerit.h"
 #include "netbuilder/FigureOfMerit/LevelCombiner.h"
+#include "netbuilder/Helpers/CyclicInnerProd.h"
 
 #include "latticetester/Weights.h"
 
 #include "latbuilder/Kernel/Base.h"
 #include "latbuilder/Types.h"
 #include "latbuilder/Storage.h"
+#include "latbuilder/Parallel.h"
 #include "latbuilder/SizeParam.h"
 #include "latbuilder/ClonePtr.h"
 #include "latbuilder/MeritSeq/CoordUniformStateCreator.h"
 #include "latbuilder/MeritSeq/CoordUniformInnerProd.h"
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
 namespace NetBuilder{ namespace FigureOfMerit { 
 
     namespace{
@@ -147,6 +154,29 @@ namespace NetBuilder{ namespace FigureOfMerit {
                 KERNEL m_kernel;
                 pCombiner m_combiner;
 
+                typedef LatBuilder::Storage<LatBuilder::LatticeType::DIGITAL, ET,  KERNEL::suggestedCompression()> Storage;
+
+                std::mutex m_kernelValuesMutex;
+                std::map<unsigned int, std::weak_ptr<const RealVector>> m_kernelValues; // kernel values in use, by number of columns
+
+                /**
+                 * Returns the kernel values for nets with \c m columns, stored in \c storage. 
+                 * The values are computed once and shared read-only by all the evaluators which use them at the
+                 * same time, for instance by the evaluators of the threads of a batch evaluation.
+                 * This function can be called concurrently.
+                 */ 
+                std::shared_ptr<const RealVector> kernelValues(unsigned int m, const Storage& storage)
+                {
+                    std::lock_guard<std::mutex> lock(m_kernelValuesMutex);
+                    auto values = m_kernelValues[m].lock();
+                    if (!values)
+                    {
+                        values = std::make_shared<const RealVector>(kernel().valuesVector(storage));
+                        m_kernelValues[m] = values;
+                    }
+                    return values;
+                }
+
                 /** 
                  * Class which describes how the figure of merit is computed. 
                  */
@@ -167,7 +197,10 @@ namespace NetBuilder{ namespace FigureOfMerit {
                             m_storage(m_sizeParam),
                             m_innerProd(m_storage, m_figure->kernel()),
                             m_memStates(LatBuilder::MeritSeq::CoordUniformStateCreator::create(m_innerProd.internalStorage(), m_figure->weights())),
-                            m_tmpStates(LatBuilder::MeritSeq::CoordUniformStateCreator::create(m_innerProd.internalStorage(), m_figure->weights()))
+                            m_tmpStates(LatBuilder::MeritSeq::CoordUniformStateCreator::create(m_innerProd.internalStorage(), m_figure->weights())),
+                            m_hasWeightedState(false),
+                            m_numEvaluated(0),
+                            m_hasCyclicProducts(false)
                         {};
 
 
@@ -183,14 +216,24 @@ namespace NetBuilder{ namespace FigureOfMerit {
                          * Returns the total weighted state.
                          */
                         RealVector weightedState() const
+                        {
+                            RealVector out;
+                            weightedState(out);
+                            return out;
+                        }
+
+                        /**
+                         * Computes the total weighted state into \c out, without temporary vectors.
+                         * @param out Output vector, resized if needed.
+                         */
+                        void weightedState(RealVector& out) const
                         {
                             auto it = states().begin();
                             if (it == states().end())
                             throw std::runtime_error("CoordUniformCBC: empty list of states");
-                            auto out = (*it)->weightedState();
+                            (*it)->weightedState(out, false);
                             while (++it != states().end())
-                            out += (*it)->weightedState();
-                            return out;
+                            (*it)->weightedState(out, true);
                         }
 
                         /**     
@@ -200,6 +243,7 @@ namespace NetBuilder{ namespace FigureOfMerit {
                         {
                             m_memStates = LatBuilder::MeritSeq::CoordUniformStateCreator::create(m_innerProd.internalStorage(), m_figure->weights());
                             m_tmpStates = LatBuilder::MeritSeq::CoordUniformStateCreator::create(m_innerProd.internalStorage(), m_figure->weights());
+                            clearCoordinateCache();
                         }
 
                         /** 
@@ -236,9 +280,7 @@ namespace NetBuilder{ namespace FigureOfMerit {
                             MeritValue acc = initialValue; // create the accumulator from the initial value
 
                             lastMatrix = net.generatingMatrix(dimension);
-                            std::vector<GeneratingMatrix> genSeq {lastMatrix};
-                            auto prodSeq = m_innerProd.prodSeq(genSeq, weightedState());
-                            auto merit = *(prodSeq.begin());
+                            auto merit = innerProd(net, lastMatrix, std::integral_constant<bool, ET == LatBuilder::EmbeddingType::UNILEVEL>());
                             m_sizeParam.normalize(merit);
                             acc += combine(merit);
 
@@ -258,6 +300,7 @@ namespace NetBuilder{ namespace FigureOfMerit {
                         virtual void prepareForNextDimension() override
                         {
                             m_memStates = m_tmpStates;
+                            clearCoordinateCache();
                         } 
 
                         /**
@@ -279,9 +322,11 @@ namespace NetBuilder{ namespace FigureOfMerit {
                                 m_numLevels = m;
                                 m_sizeParam = SizeParam(1 << m);
                                 m_storage = Storage(m_sizeParam);
-                                m_innerProd = InnerProd(m_storage, m_figure->kernel());
+                                m_innerProd = InnerProd(m_storage, m_figure->kernelValues(m, m_storage));
                                 m_memStates = LatBuilder::MeritSeq::CoordUniformStateCreator::create(m_innerProd.internalStorage(), m_figure->weights());
                                 m_tmpStates = LatBuilder::MeritSeq::CoordUniformStateCreator::create(m_innerProd.internalStorage(), m_figure->weights());
+                                m_cyclicProd = CyclicInnerProd();
+                                clearCoordinateCache();
                             }
                         }
 
@@ -294,7 +339,113 @@ namespace NetBuilder{ namespace FigureOfMerit {
 
                     private:
 
-                        typedef LatBuilder::Storage<LatBuilder::LatticeType::DIGITAL, ET,  KERNEL::suggestedCompression()> Storage;
+                        /**
+                         * Forgets the weighted state and the inner products computed for the current coordinate.
+                         */ 
+                        void clearCoordinateCache()
+                        {
+                            m_hasWeightedState = false;
+                            m_numEvaluated = 0;
+                            m_hasCyclicProducts = false;
+                        }
+
+                        /**
+                         * Returns the total weighted state, which is computed once per coordinate.
+                         */ 
+                        const RealVector& cachedWeightedState()
+                        {
+                            if (!m_hasWeightedState)
+                            {
+                                weightedState(m_weightedState);
+                                m_hasWeightedState = true;
+                            }
+                            return m_weightedState;
+                        }
+
+                        /**
+                         * Computes the inner product of the weighted state with the kernel values permuted by \c matrix
+                         * for multilevel storage.
+                         */ 
+                        typename LatBuilder::Storage<LatBuilder::LatticeType::DIGITAL, ET, KERNEL::suggestedCompression()>::MeritValue
+                        innerProd(const AbstractDigitalNet& net, const GeneratingMatrix& matrix, std::false_type)
+                        {
+                            std::vector<GeneratingMatrix> genSeq {matrix};
+                            auto prodSeq = m_innerProd.prodSeq(genSeq, cachedWeightedState());
+                            return *(prodSeq.begin());
+                        }
+
+                        /**
+                         * Computes the inner product of the weighted state with the kernel values permuted by \c matrix
+                         * for unilevel storage.
+                         * 
+                         * From the second polynomial net evaluated for a coordinate on, the inner products for all the
+                         * polynomials are computed at once with a cyclic correlation if the modulus is irreducible.
+                         * Otherwise, the permutation is applied on the fly by following the Gray code, as in the
+                         * digital storage, without creating the permuted vector, on chunks of indices processed
+                         * in parallel.
+                         */ 
+                        Real innerProd(const AbstractDigitalNet& net, const GeneratingMatrix& matrix, std::true_type)
+                        {
+                            const RealVector& state = cachedWeightedState();
+                            const RealVector& kernelValues = m_innerProd.kernelValues();
+                            const uInteger size = kernelValues.size();
+
+                            if (matrix.nRows() != matrix.nCols() || state.size() != size)
+                            {
+                                std::vector<GeneratingMatrix> genSeq {matrix};
+                                auto prodSeq = m_innerProd.prodSeq(genSeq, state);
+                                return *(prodSeq.begin());
+                            }
+
+                            const auto polynomialNet = dynamic_cast<const DigitalNet<NetConstruction::POLYNOMIAL>*>(&net);
+                            if (polynomialNet && ++m_numEvaluated >= 2)
+                            {
+                                const auto modulus = polynomialNet->sizeParameter();
+                                if (m_cyclicProd.modulus() != LatBuilder::IndexOfPolynomial(modulus))
+                                {
+                                    m_cyclicProd.init(modulus, kernelValues);
+                                    m_hasCyclicProducts = false;
+                                }
+                                if (m_cyclicProd.isValid())
+                                {
+                                    if (!m_hasCyclicProducts)
+                                    {
+                                        m_cyclicProd.computeProducts(state);
+                                        m_hasCyclicProducts = true;
+                                    }
+                                    return m_cyclicProd.product(matrix);
+                                }
+                            }
+
+                            const std::vector<unsigned long> cols = matrix.getColsReverse();
+                            return LatBuilder::chunkedSum(size, [&] (uInteger begin, uInteger end)
+                            {
+                                // permuted index of the Gray code of begin
+                                uInteger index = 0;
+                                const uInteger gray = begin ^ (begin >> 1);
+                                for (unsigned int bit = 0; bit < cols.size(); ++bit)
+                                {
+                                    if ((gray >> bit) & 1)
+                                    {
+                                        index ^= cols[bit];
+                                    }
+                                }
+                                Real res = state[begin] * kernelValues[index];
+                                for (uInteger i = begin + 1; i < end; ++i)
+                                {
+                                    // the Gray code of i differs from that of i-1 by the lowest set bit of i
+                                    unsigned int bit = 0;
+                                    for (uInteger j = i; !(j & 1); j >>= 1)
+                                    {
+                                        ++bit;
+                                    }
+                                    index ^= cols[bit];
+                                    res += state[i] * kernelValues[index];
+                                }
+                                return res;
+                            });
+                        }
+
                         typedef LatBuilder::SizeParam<LatBuilder::LatticeType::DIGITAL, ET> SizeParam;
                         typedef LatBuilder::MeritSeq::CoordUniformInnerProd<LatBuilder::LatticeType::DIGITAL, ET,  KERNEL::suggestedCompression(), LatBuilder::PerLevelOrder::BASIC > InnerProd;
                         typedef CoordUniformStateList<LatBuilder::LatticeType::DIGITAL, KERNEL::suggestedCompression()> StateList;
@@ -313,6 +464,12 @@ namespace NetBuilder{ namespace FigureOfMerit {
 
                         GeneratingMatrix lastMatrix; // last matrix of latets evaluated net for the current dimension
 
+                        RealVector m_weightedState; // weighted state for the current dimension
+                        bool m_hasWeightedState;
+                        unsigned int m_numEvaluated; // number of nets evaluated for the current dimension
+                        CyclicInnerProd m_cyclicProd; // inner products for all the polynomials at once
+                        bool m_hasCyclicProducts; // whether m_cyclicProd holds the products for the current dimension
+
                 };
 
 };
@@ -40,6 +40,8 @@ namespace NetBuilder { namespace FigureOfMerit {
 
 using LatBuilder::Functor::AllOf;
 
+class ProjectionTValueCache;
+
 /** 
  * Evaluator abstract class to evaluate figure of merit for a net.
  */ 
@@ -199,6 +201,13 @@ class CBCFigureOfMeritEvaluator:
          */
         virtual void lastNetWasBest() = 0;
 
+        /**
+         * Sets the cache of the t-values of projections shared with the other evaluators of a combined figure of merit.
+         * Evaluators which do not compute t-values of projections ignore the cache.
+         * @param cache Pointer to the cache, or \c nullptr to compute all the t-values.
+         */
+        virtual void setTValueCache(ProjectionTValueCache* cache) {}
+
 };
 
 /**
@@ -0,0 +1,162 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * \file
+ * This file contains the definition of the persistent cache of the t-values of projections.
+ */ 
+
+#ifndef NET_BUILDER__FIGURE_OF_MERIT__PERSISTENT_TVALUE_CACHE_H
+#define NET_BUILDER__FIGURE_OF_MERIT__PERSISTENT_TVALUE_CACHE_H
+
+#include "netbuilder/Types.h"
+#include "netbuilder/GeneratingMatrix.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NetBuilder { namespace FigureOfMerit {
+
+/** 
+ * Persistent cache of the t-values of projections, stored as a hash table in a memory-mapped file
+ * which is shared by the evaluators of all the threads and of all the processes using the same file.
+ * The t-value of a projection is identified by a 128-bit hash of the content of the generating matrices 
+ * of the coordinates of the projection, of the number of rows and columns of the matrices and of the level
+ * for multilevel t-values. Therefore, the t-values computed by a search can be reused by later searches
+ * sharing some coordinates, for instance after extending the dimension or changing the weights.
+ * 
+ * The path of the file is initialized from the \c LATNETBUILDER_TVALUE_CACHE environment variable and can be changed with setPath().
+ * The file is created if required. The cache is disabled when the path is empty, and on platforms without memory-mapped files.
+ * The table has a fixed number of slots: when the slots probed for a new entry are all used, an entry is replaced.
+ * Each slot holds a checksum, so that a slot which is written concurrently is never read as a valid entry.
+ */ 
+class PersistentTValueCache
+{
+    public:
+
+        /** 
+         * 128-bit hash.
+         */ 
+        struct Hash
+        {
+            uint64_t first;
+            uint64_t second;
+        };
+
+        /** 
+         * Number of slots of a new cache file.
+         */ 
+        static constexpr size_t DefaultCapacity = size_t(1) << 22;
+
+        /** 
+         * Sets the path of the file of the cache. An empty string disables the cache.
+         * Must be called before the evaluators of the figures of merit are created.
+         * @param path Path of the file.
+         */ 
+        static void setPath(std::string path);
+
+        /** 
+         * Returns the cache of the process, or \c nullptr if the cache is disabled or if the file cannot be used.
+         */ 
+        static PersistentTValueCache* instance();
+
+        /** 
+         * Returns the hash of the content of \c matrix.
+         * @param matrix Generating matrix.
+         */ 
+        static Hash hash(const GeneratingMatrix& matrix);
+
+        /** 
+         * Returns the key of the t-value of a projection.
+         * @param matrixHashes Hashes of the generating matrices of the coordinates, indexed by coordinate.
+         * @param projection Projection.
+         * @param nRows Number of rows of the generating matrices.
+         * @param nCols Number of columns of the generating matrices.
+         */ 
+        static Hash key(const std::vector<Hash>& matrixHashes, const Projection& projection, unsigned int nRows, unsigned int nCols);
+
+        /** 
+         * Finds the unilevel t-value with key \c key.
+         * @param key Key of the t-value.
+         * @param tValue Set to the t-value if it is found.
+         * @return Whether the t-value is found.
+         */ 
+        bool find(const Hash& key, unsigned int& tValue) const;
+
+        /** 
+         * Finds the multilevel t-values with key \c key, for as many levels as the size of \c tValues.
+         * @param key Key of the t-values.
+         * @param tValues Set to the t-values if they are all found.
+         * @return Whether the t-values are all found.
+         */ 
+        bool find(const Hash& key, std::vector<unsigned int>& tValues) const;
+
+        /** 
+         * Stores the unilevel t-value \c tValue with key \c key.
+         * @param key Key of the t-value.
+         * @param tValue t-value.
+         */ 
+        void insert(const Hash& key, unsigned int tValue);
+
+        /** 
+         * Stores the multilevel t-values \c tValues with key \c key.
+         * @param key Key of the t-values.
+         * @param tValues t-values.
+         */ 
+        void insert(const Hash& key, const std::vector<unsigned int>& tValues);
+
+        /** 
+         * Unmaps the file.
+         */ 
+        ~PersistentTValueCache();
+
+        PersistentTValueCache(const PersistentTValueCache&) = delete;
+        PersistentTValueCache& operator=(const PersistentTValueCache&) = delete;
+
+    private:
+
+        struct Slot;
+
+        /** 
+         * Constructor.
+         * @param data Mapped file.
+         * @param bytes Size of the mapped file.
+         * @param capacity Number of slots.
+         */ 
+        PersistentTValueCache(void* data, size_t bytes, size_t capacity);
+
+        /** 
+         * Opens the cache stored in the file at \c path, or returns \c nullptr if the file cannot be used.
+         * @param path Path of the file.
+         */ 
+        static PersistentTValueCache* open(const std::string& path);
+
+        /** 
+         * Returns the key of the t-value of level \c level of the multilevel t-values with key \c key.
+         */ 
+        static Hash levelKey(const Hash& key, unsigned int level);
+
+        void* m_data; // mapped file
+        size_t m_bytes; // size of the mapped file
+        Slot* m_slots; // slots of the hash table
+        size_t m_capacity; // number of slots, a power of two
+};
+
+}}
+
+#endif
@@ -18,6 +18,14 @@
 #define NETBUILDER__FIGURE_OF_MERIT_BIT__PROJECTION_DEPENDENT_EVALUATOR
 
 #include "netbuilder/FigureOfMerit/WeightedFigureOfMerit.h"
+#include "netbuilder/FigureOfMerit/ProjectionTValueCache.h"
+#include "netbuilder/FigureOfMerit/PersistentTValueCache.h"
+
+#include "netbuilder/WeightTable.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 namespace NetBuilder { namespace FigureOfMerit {
 
@@ -25,6 +33,19 @@ namespace NetBuilder { namespace FigureOfMerit {
  * Class to implement the evaluation of specific projection-dependent weighted figure of merit where
  * the merits of the subprojections of order one less are used to compute the merit of a bigger projection, for instance
  * the t-value of subprojections. 
+ * The projections are stored in contiguous arrays (one array by field of the projections), layer by layer, 
+ * so that the evaluation of a layer is a linear scan of these arrays.
+ * The projections of each layer are taken from a compiled table of the weights, so that the projections with
+ * a zero weight are neither stored nor evaluated.
+ * The projection-dependent merit is given a predicate telling whether a combined merit would keep the accumulated merit
+ * acceptable for the listeners of onProgress(), so that it can stop computing the merit of a projection
+ * as soon as it is proven to be rejected.
+ * When someone is listening, the evaluation of a layer is also aborted as soon as the accumulated merit plus a lower bound
+ * on the merits of the remaining projections is rejected. The lower bound of a projection is computed by the projection-dependent
+ * merit from the merits of its subprojections in the previous layers. Within each cardinal, the projections are evaluated first by
+ * decreasing number of abortions they caused for the previous nets, while the merit is accumulated in the static order.
+ * When the persistent cache is enabled (see PersistentTValueCache), the accepted merits of the projections are stored in the cache
+ * and the merits found in the cache are not computed again.
  * @tparam PROJDEP Template parameter representing the projection-dependent merit.
  */ 
 template <typename PROJDEP>
@@ -42,27 +63,11 @@ class ProjectionDependentEvaluator : public CBCFigureOfMeritEvaluator
                     m_figure(figure),
                     m_numCoordinates(0),
                     m_maxNumCoordinates(0),
-                    m_maxCardinal(m_figure->projDepMerit().maxCardinal())
+                    m_maxCardinal(m_figure->projDepMerit().maxCardinal()),
+                    m_weightTable(m_figure->weights(), m_maxCardinal),
+                    m_persistentCache(PersistentTValueCache::instance())
         {};
 
-        /** 
-         * Destructor. */
-        ~ProjectionDependentEvaluator()
-        {
-            for(Dimension dim = 0; dim < m_maxNumCoordinates; ++dim)
-            {
-                ProjectionNode* it = m_roots[dim];
-                ProjectionNode* nextIt = nullptr;
-                do
-                {
-                    nextIt = it->getNextNode();
-                    delete it;
-                    it = nextIt;
-                }
-                while(it != nullptr);
-            }
-        }
-
         /** 
          * Computes the figure of merit for the given \c net for the given \c dimension (partial computation), 
          * starting from the initial value \c initialValue.
@@ -75,39 +80,99 @@ class ProjectionDependentEvaluator : public CBCFigureOfMeritEvaluator
         {
             unsigned int nLevels = PROJDEP::numLevels(net); // determine the number of levels
 
+            const Real initial = initialValue;
             auto acc = m_figure->accumulator(std::move(initialValue));
 
-            ProjectionNode* it = m_roots[dimension]; // iterator over the nodes
-            do
-            {   
-                Real weight = it->getWeight();
-                
-                if (PROJDEP::size(it->getSubProjCombination()) < nLevels) // resize the subprojections combination if required
+            const size_t begin = m_layerBegin[dimension];
+            const size_t numNodes = m_layerBegin[dimension + 1] - begin;
+
+            if (m_persistentCache) // the hashes of the generating matrices of the previous net are not relevant
+            {
+                ++m_numCalls;
+                m_matrixHashes.resize(dimension + 1);
+                m_hashCalls.resize(dimension + 1, 0);
+            }
+
+            // without listeners, the computation is never aborted, so the nodes are evaluated in the static order without bounds
+            const bool bounded = !onProgress().empty();
+            if (bounded)
+            {
+                prepareBounds(net, dimension);
+                if (!onProgress()(acc.tryAccumulate(1, m_remainingBound[0], 1))) // the lower bound alone is already rejected
+                {
+                    acc.set(std::numeric_limits<Real>::infinity()); // set the merit to infinity
+                    onAbort()(net); // abort the computation
+                    return acc.value();
+                }
+            }
+
+            for (size_t pos = 0; pos < numNodes; ++pos) // linear scan of the nodes of the layer
+            {
+                const size_t node = bounded ? m_order[begin + pos] : begin + pos;
+                Real weight = m_weights[node];
+
+                if (PROJDEP::size(m_subProjCombinations[node]) < nLevels) // resize the subprojections combination if required
                 {
-                    PROJDEP::resize(it->getSubProjCombination(), nLevels);
+                    PROJDEP::resize(m_subProjCombinations[node], nLevels);
                 }
 
-                it->updateSubProjCombination(); // update the subprojection combination
+                updateSubProjCombination(node, dimension); // update the subprojection combination
+
+                const Projection& proj = m_projections[node];
+
+                // accumulated merit plus the lower bound on the merits of the nodes which remain to evaluate
+                auto bound = m_figure->accumulator(acc.tryAccumulate(1, bounded ? m_remainingBound[pos + 1] : 0, 1));
 
-                LatticeTester::Coordinates proj = it->getProjectionRepresentation();
+                // whether the merit of the projection would leave the bounded merit acceptable
+                auto accept = [this, &bound, weight](Real merit) -> bool { return onProgress()(bound.tryAccumulate(weight, merit, 1)); };
 
-                auto grossMerit = m_figure->projDepMerit()(net, proj ,it->getSubProjCombination()); // compute the merit of the projection
+                // the merits of the projections of order one are not worth storing in the persistent cache
+                const bool persistent = m_persistentCache && m_cardinals[node] > 1;
+                const PersistentTValueCache::Hash key = persistent ? persistentKey(net, proj) : PersistentTValueCache::Hash{0, 0};
+
+                MeritStorage grossMerit = m_subProjCombinations[node]; // the merit has the size of the combination
+                const bool found = persistent && m_persistentCache->find(key, grossMerit);
+                if (!found)
+                {
+                    // compute the merit of the projection, or only enough of it to prove that it is rejected
+                    grossMerit = m_tValueCache ? 
+                            m_figure->projDepMerit()(net, proj, m_subProjCombinations[node], accept, *m_tValueCache) :
+                            m_figure->projDepMerit()(net, proj, m_subProjCombinations[node], accept);
+                }
 
                 Real merit = m_figure->projDepMerit().combine(grossMerit, net, proj); // combine in a single merit value
 
                 acc.accumulate(weight,merit,1);
 
-                if (!onProgress()(acc.value()))  // if someone is listening, may tell that the computation is useless
+                if (!onProgress()(bound.tryAccumulate(weight, merit, 1)))  // if someone is listening, may tell that the computation is useless
                 {
-                    acc.accumulate(std::numeric_limits<Real>::infinity(), merit, 1); // set the merit to infinity
+                    if (bounded)
+                    {
+                        recordAbort(dimension, pos);
+                    }
+                    acc.set(std::numeric_limits<Real>::infinity()); // set the merit to infinity
                     onAbort()(net); // abort the computation
-                    break;
+                    return acc.value();
                 }
 
-                it->setMeritTmp(grossMerit); // update the merit of the node
-                it = it->getNextNode(); // skip to next node
+                if (persistent && !found) // the merit is accepted, so it is not only a lower bound
+                {
+                    m_persistentCache->insert(key, grossMerit);
+                }
+
+                m_meritsTmp[node] = std::move(grossMerit); // update the merit of the node
+                m_combinedMerits[node] = merit;
+            }
+
+            if (bounded)
+            {
+                // accumulate again in the static order, so that the merit does not depend on the evaluation order
+                acc.set(initial);
+                for (size_t node = begin; node < begin + numNodes; ++node)
+                {
+                    acc.accumulate(m_weights[node], m_combinedMerits[node], 1);
+                }
             }
-            while(it != nullptr);
 
             return acc.value();
         }
@@ -115,7 +180,17 @@ class ProjectionDependentEvaluator : public CBCFigureOfMeritEvaluator
         /**     
          * Resets the evaluator and prepare it to evaluate a new net.
          */ 
-        virtual void reset() override { m_numCoordinates=0; }
+        virtual void reset() override 
+        { 
+            m_numCoordinates=0; 
+            m_boundsDimension = std::numeric_limits<Dimension>::max(); // the stored merits will change
+        }
+
+        /**
+         * Sets the cache of the t-values of projections shared with the other evaluators of a combined figure of merit.
+         * @param cache Pointer to the cache, or \c nullptr to compute all the t-values.
+         */
+        virtual void setTValueCache(ProjectionTValueCache* cache) override { m_tValueCache = cache; }
 
         /**
          * Tells the evaluator that the last net was the best so far and store the relevant information
@@ -132,6 +207,7 @@ class ProjectionDependentEvaluator : public CBCFigureOfMeritEvaluator
          */ 
         virtual void prepareForNextDimension() override
         {
+            m_boundsDimension = std::numeric_limits<Dimension>::max();
             if (m_numCoordinates<m_maxNumCoordinates)
             {
                 ++m_numCoordinates;
@@ -149,242 +225,253 @@ class ProjectionDependentEvaluator : public CBCFigureOfMeritEvaluator
 
     private:
 
+        /// Type of merit value storage.
+        typedef typename PROJDEP::Merit MeritStorage;
+
+        /// Type of the combination of the merits of the subprojections.
+        typedef typename PROJDEP::SubProjCombination SubProjCombination;
+
         /** 
-         * Represents a projection. The node is linked to the projections with order one less and with the following
-         * projection in the evaluation order. The node store some merit values.
+         * Projection to be added to a new layer, before the nodes of the layer are sorted.
          */ 
-        struct ProjectionNode
+        struct NewNode
         {
-            /// Type of merit value storage.
-            typedef typename PROJDEP::Merit MeritStorage;
-
-            /// Type of the combination of the merits of the subprojections.
-            typedef typename PROJDEP::SubProjCombination SubProjCombination; 
-
-            /** 
-             * Constructor.
-             * @param dimension Highest coordinate in all the projections of the layer.
-             * @param cardinal Cardinal of the projection.
-             * @param weight Importance of the projection in the figure of merit.
-             */ 
-            ProjectionNode(Dimension dimension, unsigned int cardinal, double weight):
-                m_weight(weight),
-                m_dimension(dimension),
-                m_cardinal(cardinal)
-            {};
-
-            /** 
-             * Returns the cardinal of the projection represented by the node.
-             */ 
-            unsigned int getCardinal() const { return m_cardinal; }
-
-            /** 
-             * Returns the maximum dimension, that is the highest coordinate in all the projections of the layer.
-             */ 
-            Dimension getMaxDimension() const { return m_dimension; }
-
-            /** Returns a pointer to the next projection to evaluate. May be null.
-             */ 
-            ProjectionNode* getNextNode() const { return m_nextNode; }
-
-            /** Set the next node of the current node.
-             * @param node is a pointer to the next node.
-             */ 
-            void setNextNode(ProjectionNode* node){ m_nextNode = node; }
-
-            /** 
-             * Returns a vector of pointers to the subprojections whose cardinal is one less than the
-             * projection's.
-             */ 
-            const std::vector<ProjectionNode*>& getMotherNodes() const { return m_mothersNodes; }
+            Projection projection; // projection represented by the node
+            Real weight; // weight of the projection
+            size_t rank; // rank of the projection in the layer, in increasing order of projections
 
             /** 
-             * Returns the projection represented by the node.
+             * A projection is smaller (less important) than another one if they have the same cardinal and its weight is smaller
+             * of if it has a strictly bigger cardinal.
              */ 
-            LatticeTester::Coordinates getProjectionRepresentation() const { 
-                LatticeTester::Coordinates res;
-                accumulateProjectionRepresentation(res);
-                return res;
+            bool operator>(const NewNode& b) const
+            {
+                return (projection.size() == b.projection.size()) ? 
+                            (weight > b.weight) : 
+                            (projection.size() < b.projection.size());
             }
+        };
 
-            /**
-             * Add a mother to the projection node.
-             * @param mother Pointer to the new mother.
-             */ 
-            void addMother(ProjectionNode* mother) { m_mothersNodes.push_back(mother); }
-
-            /** 
-             * Returns the weight of the projection represented by the node.
-             */ 
-            Real getWeight() const { return m_weight; }
-
-
-            /** Returns the stored merit of the projection represented by the node.
-             */ 
-            MeritStorage getMeritMem() const {return m_meritMem; }
-
-            /** Returns the temporary merit of the projection represented by the node.
-             */ 
-            MeritStorage getMeritTmp() const {return m_meritTmp; }
-
-
-            /** 
-             * Returns the maximum of the merits of the subprojections.
-             */ 
-            SubProjCombination& getSubProjCombination() { return m_subProjCombination; }
-
-            /** 
-             * Set the temporary merit of the node to be the given merit
-             * @param merit is the merit to assign to the node.
-             */ 
-            void setMeritTmp(MeritStorage merit) {m_meritTmp = merit; }
-
-            /** 
-             * Save the temporary merit in the m_meritMem field. 
-             */ 
-            void saveMerit() {m_meritMem = m_meritTmp; }
-
-            /** 
-             * Updates the combination of the merits of the subprojections (mothers). Note that for
-             * subprojections which also contain getMaxDimension(), the temporary merit is used
-             * whereas for other nodes, the stored merit is used. This allows component-by-component
-             * evaluation for several nets with a unique datastructure..
-             */ 
-            void updateSubProjCombination()
+        /** 
+         * Updates the combination of the merits of the subprojections (mothers) of \c node. Note that for
+         * subprojections which also contain \c dimension, the temporary merit is used
+         * whereas for other nodes, the stored merit is used. This allows component-by-component
+         * evaluation for several nets with a unique datastructure.
+         * @param node Index of the node.
+         * @param dimension Highest coordinate of the projection represented by the node.
+         */ 
+        void updateSubProjCombination(size_t node, Dimension dimension)
+        {
+            if (m_cardinals[node] > 1)
             {
-                if (getCardinal() > 1)
+                SubProjCombination& combination = m_subProjCombinations[node];
+                PROJDEP::setToZero(combination);
+                const size_t layerBegin = m_layerBegin[dimension];
+                for (size_t k = m_motherBegin[node]; k < m_motherBegin[node + 1]; ++k)
                 {
-                    PROJDEP::setToZero(m_subProjCombination);
-                    for (auto const* m : m_mothersNodes)
+                    const size_t mother = m_mothers[k];
+                    if (mother < layerBegin)
                     {
-                        if (m->getMaxDimension() < m_dimension)
-                        {
-                            PROJDEP::update(m->getMeritMem(), m_subProjCombination);
-                        }
-                        else{
-                            PROJDEP::update(m->getMeritTmp(), m_subProjCombination);
-                        } 
+                        PROJDEP::update(m_meritsMem[mother], combination);
+                    }
+                    else
+                    {
+                        PROJDEP::update(m_meritsTmp[mother], combination);
                     }
                 }
             }
+        }
 
-            /** 
-             * Overloads operator < to compare projections. A projection is smaller (less important) than another one if they have the same cardinal and its weight is smaller
-             * of if it has a strictly bigger cardinal.
-             */ 
-            bool operator>(const ProjectionNode &b) const
+        /** 
+         * Computes, if not already done for \c dimension, the lower bounds on the merits of the nodes of the layer of \c dimension
+         * and the lower bounds on the merits of the nodes which remain to evaluate at each position of the evaluation order.
+         * The lower bound of a node is obtained from its subprojections of the previous layers, whose merits are stored,
+         * so that the bounds hold for all the nets evaluated for \c dimension.
+         * @param net Digital net.
+         * @param dimension Dimension of the layer.
+         */ 
+        void prepareBounds(const AbstractDigitalNet& net, Dimension dimension)
+        {
+            if (m_boundsDimension == dimension)
             {
-                return (getCardinal() == b.getCardinal()) ? 
-                            (getWeight() > b.getWeight()) : 
-                            (getCardinal() < b.getCardinal());
+                return;
+            }
+            const unsigned int nLevels = PROJDEP::numLevels(net);
+            const size_t layerBegin = m_layerBegin[dimension];
+            for (size_t node = layerBegin; node < m_layerBegin[dimension + 1]; ++node)
+            {
+                SubProjCombination combination;
+                PROJDEP::resize(combination, nLevels);
+                PROJDEP::setToZero(combination);
+                for (size_t k = m_motherBegin[node]; k < m_motherBegin[node + 1]; ++k)
+                {
+                    if (m_mothers[k] < layerBegin)
+                    {
+                        PROJDEP::update(m_meritsMem[m_mothers[k]], combination);
+                    }
+                }
+                m_lowerBounds[node] = m_figure->projDepMerit().meritLowerBound(combination, net, m_projections[node]);
             }
+            updateRemainingBound(dimension, m_layerBegin[dimension + 1] - layerBegin);
+            m_boundsDimension = dimension;
+        }
 
-            /** 
-             * Comparison between pointers to nodes by dereferencing. Used to sort by decreasing importance.
-             */ 
-            static bool compareNodePointers(const ProjectionNode* a, const ProjectionNode* b){
-                return (*a > * b);
+        /** 
+         * Updates the lower bounds on the merits of the nodes which remain to evaluate for the positions
+         * of the evaluation order of the layer of \c dimension which are smaller than \c end.
+         * @param dimension Dimension of the layer.
+         * @param end Position from which the bounds are up to date.
+         */ 
+        void updateRemainingBound(Dimension dimension, size_t end)
+        {
+            const size_t layerBegin = m_layerBegin[dimension];
+            const size_t numNodes = m_layerBegin[dimension + 1] - layerBegin;
+            m_remainingBound.resize(numNodes + 1);
+            if (end == numNodes)
+            {
+                m_remainingBound[numNodes] = 0;
             }
-                    
-            /** 
-             * Overloading of the << operator to print projection nodes.
-             */
-            friend std::ostream& operator<<(std::ostream& os, const ProjectionNode& dt)
+            auto acc = m_figure->accumulator(m_remainingBound[end]);
+            for (size_t pos = end; pos-- > 0; )
             {
-                os << "projection: " << dt.getProjectionRepresentation() << " - weight: " << dt.getWeight();
-                return os;
+                const size_t node = m_order[layerBegin + pos];
+                acc.accumulate(m_weights[node], m_lowerBounds[node], 1);
+                m_remainingBound[pos] = acc.value();
             }
+        }
 
-            double m_weight; // weight of the projection
-            Dimension m_dimension; // last dimension (highest coordinate in the projection)
-            unsigned int m_cardinal; // cardinal of the projection
-
-            ProjectionNode* m_nextNode = nullptr; // pointer to the next projection to evaluate
-            std::vector<ProjectionNode*> m_mothersNodes; // pointers to the subprojections whose cardinal is one less
-
-            SubProjCombination m_subProjCombination; // combination of the merits of the subprojections
-
-            MeritStorage m_meritMem; // stored merit
-            MeritStorage m_meritTmp; // temporay merit
+        /** 
+         * Records that the evaluation of the layer of \c dimension was aborted after the node at position \c pos 
+         * of the evaluation order. The node is moved before the nodes with the same cardinal which caused fewer abortions,
+         * so that the nodes which are likely to reject a net are evaluated first.
+         * @param dimension Dimension of the layer.
+         * @param pos Position of the node in the evaluation order.
+         */ 
+        void recordAbort(Dimension dimension, size_t pos)
+        {
+            const size_t layerBegin = m_layerBegin[dimension];
+            const size_t node = m_order[layerBegin + pos];
+            const size_t end = pos + 1;
+            ++m_aborts[node];
+            while (pos > 0)
+            {
+                const size_t previous = m_order[layerBegin + pos - 1];
+                if (m_cardinals[previous] != m_cardinals[node] || m_aborts[previous] >= m_aborts[node])
+                {
+                    break;
+                }
+                m_order[layerBegin + pos] = previous;
+                --pos;
+            }
+            if (pos + 1 < end)
+            {
+                m_order[layerBegin + pos] = node;
+                updateRemainingBound(dimension, end);
+            }
+        }
 
-            void accumulateProjectionRepresentation(LatticeTester::Coordinates& projection) const
+        /** 
+         * Returns the key of the merit of \c projection for \c net in the persistent cache. The hashes of the generating
+         * matrices are computed once by evaluation.
+         * @param net Digital net.
+         * @param projection Projection.
+         */ 
+        PersistentTValueCache::Hash persistentKey(const AbstractDigitalNet& net, const Projection& projection)
+        {
+            for (auto coord : projection)
             {
-                projection.insert(m_dimension);
-                if(m_cardinal>1)
+                if (m_hashCalls[coord] != m_numCalls)
                 {
-                    m_mothersNodes[0]->accumulateProjectionRepresentation(projection);
+                    m_matrixHashes[coord] = PersistentTValueCache::hash(net.generatingMatrix(coord));
+                    m_hashCalls[coord] = m_numCalls;
                 }
             }
-        };
+            return PersistentTValueCache::key(m_matrixHashes, projection, net.numRows(), net.numColumns());
+        }
+
+        /** 
+         * Returns the index of the node representing \c projection, or the maximal value of \c size_t
+         * if there is no such node (if the weight of the projection is zero).
+         * @param projection Nonempty projection.
+         */ 
+        size_t findNode(const Projection& projection) const
+        {
+            const Dimension layer = projection.back();
+            auto first = m_sortedNodes.begin() + m_layerBegin[layer];
+            auto last = m_sortedNodes.begin() + m_layerBegin[layer + 1];
+            auto it = std::lower_bound(first, last, projection, 
+                        [this](size_t node, const Projection& proj) { return m_projections[node] < proj; });
+            return (it != last && m_projections[*it] == projection) ? *it : std::numeric_limits<size_t>::max();
+        }
 
         /** 
          * Extends by one dimension the evaluator. This creates new nodes corresponding to the new projections to consider
          * while evaluating figures of merits.
          */ 
-        void extend(){
+        void extend()
+        {
             ++m_maxNumCoordinates; // increase maximal number of coordinates
-            std::vector<ProjectionNode*> newNodes; // to store new nodes
-
-            std::map<LatticeTester::Coordinates,ProjectionNode*> mapsToNodes; // map between new projections and new nodes
+            const Dimension newCoordinate = m_maxNumCoordinates - 1;
+            const size_t numOldNodes = m_layerBegin.back();
 
-            // create projection {m_numCoordinates} 
-            LatticeTester::Coordinates proj1DRep;
-            proj1DRep.insert(m_maxNumCoordinates-1);
-            double weight = m_figure->weights().getWeight(proj1DRep);
-            ProjectionNode* proj1D = new ProjectionNode(m_maxNumCoordinates-1, (unsigned int) proj1DRep.size(), weight);
+            // projections with largest coordinate newCoordinate and a nonzero weight, sorted by projection
+            const WeightTable::Layer& entries = m_weightTable.layer(newCoordinate);
 
-            if(m_maxNumCoordinates==1){
-                m_roots.push_back(proj1D);
-                return;
+            std::vector<NewNode> newNodes; // to store new nodes
+            newNodes.reserve(entries.size());
+            for (size_t i = 0; i < entries.size(); ++i)
+            {
+                newNodes.push_back(NewNode{entries[i].first, entries[i].second, i});
             }
 
-            newNodes.push_back(proj1D);
+            std::stable_sort(newNodes.begin(), newNodes.end(), [](const NewNode& a, const NewNode& b) { return a > b; }); // sort the nodes by increasing cardinal and decreasing weights
 
-            mapsToNodes.insert(std::pair<LatticeTester::Coordinates,ProjectionNode*>(std::move(proj1DRep),proj1D));
+            const size_t numNodes = numOldNodes + newNodes.size();
+            m_weights.reserve(numNodes);
+            m_cardinals.reserve(numNodes);
+            m_projections.reserve(numNodes);
+            m_motherBegin.reserve(numNodes + 1);
+            m_sortedNodes.resize(numNodes);
 
+            for (size_t k = 0; k < newNodes.size(); ++k) // for each new nodes
+            {   
+                m_sortedNodes[numOldNodes + newNodes[k].rank] = numOldNodes + k;
+                m_weights.push_back(newNodes[k].weight);
+                m_cardinals.push_back((unsigned int) newNodes[k].projection.size());
+                m_projections.push_back(std::move(newNodes[k].projection));
+            }
+            m_layerBegin.push_back(numNodes);
 
-            for(unsigned int i = 0; i < m_maxNumCoordinates-1; ++i) // for each previous dimensions
+            for (size_t node = numOldNodes; node < numNodes; ++node) // link the new nodes to their mothers
             {
-                ProjectionNode* it = m_roots[i];
-                do
-                {   if (it->getCardinal() <= m_maxCardinal-1)
+                const Projection& tmp = m_projections[node];
+                if (tmp.size() > 1)
+                {
+                    for (auto i : tmp)
                     {
-                        LatticeTester::Coordinates projectionRep = it->getProjectionRepresentation(); // consider the projection
-                        projectionRep.insert(m_maxNumCoordinates-1);
-                        double weight =  m_figure->weights().getWeight(projectionRep);
-                        ProjectionNode* newNode = new ProjectionNode(m_maxNumCoordinates-1, (unsigned int) projectionRep.size() , weight); // create the node
-                        newNode->addMother(it);
-                        mapsToNodes.insert(std::pair<LatticeTester::Coordinates,ProjectionNode*>(std::move(projectionRep),newNode));
-                        newNodes.push_back(newNode);
+                        // subprojections with a zero weight have no node: the combination of the merits of the subprojections
+                        // is then computed on fewer subprojections
+                        const size_t mother = findNode(tmp.without(i));
+                        if (mother != std::numeric_limits<size_t>::max())
+                        {
+                            m_mothers.push_back(mother);
+                        }
                     }
-                    it = it->getNextNode();
                 }
-                while(it != nullptr);
+                m_motherBegin.push_back(m_mothers.size());
             }
 
-            std::sort(newNodes.begin(), newNodes.end(), ProjectionNode::compareNodePointers); // sort the nodes by increasing cardinal and decreasing weights
-
-            m_roots.push_back(newNodes[0]); // add the root corresponding to the dimension
-
-            for(size_t i = 0; i < newNodes.size()-1; ++i)
+            for (size_t node = numOldNodes; node < numNodes; ++node) // the nodes are first evaluated in the static order
             {
-                newNodes[i]->setNextNode(newNodes[i+1]); // link the new nodes
+                m_order.push_back(node);
             }
+            m_aborts.resize(numNodes, 0);
+            m_lowerBounds.resize(numNodes);
+            m_combinedMerits.resize(numNodes);
 
-            for (ProjectionNode* node : newNodes) // for each new nodes
-            {   
-                LatticeTester::Coordinates tmp = node->getProjectionRepresentation();
-                for(unsigned int i = 0; i < m_maxNumCoordinates-1; ++i) // link to mothers which contains m_numCoordinates
-                {
-                    if (tmp.find(i) != tmp.end())
-                    {
-                        tmp.erase(i);
-                        auto foo = mapsToNodes.find(tmp)->second;
-                        node->addMother(foo);
-                        tmp.insert(i);
-                    }
-                }
-            }
+            m_subProjCombinations.resize(numNodes);
+            m_meritsMem.resize(numNodes);
+            m_meritsTmp.resize(numNodes);
         }
 
         /** Save the merits of all the nodes corresponding to the \c dimension.
@@ -392,13 +479,7 @@ class ProjectionDependentEvaluator : public CBCFigureOfMeritEvaluator
          */  
         void saveMerits(Dimension dimension)
         {
-            ProjectionNode* it = m_roots[dimension];
-            do
-            {
-                it->saveMerit();
-                it = it->getNextNode();
-            }
-            while(it != nullptr);
+            std::copy(m_meritsTmp.begin() + m_layerBegin[dimension], m_meritsTmp.begin() + m_layerBegin[dimension + 1], m_meritsMem.begin() + m_layerBegin[dimension]);
         }
 
         /** 
@@ -417,7 +498,33 @@ class ProjectionDependentEvaluator : public CBCFigureOfMeritEvaluator
         Dimension m_numCoordinates; 
         Dimension m_maxNumCoordinates;
         unsigned int m_maxCardinal; 
-        std::vector<ProjectionNode*> m_roots; // pointer to the first node of each layer (one by dimension)
+        WeightTable m_weightTable; // compiled weights of the projections
+        ProjectionTValueCache* m_tValueCache = nullptr; // t-values shared with other evaluators
+        PersistentTValueCache* m_persistentCache; // t-values shared with other searches, or nullptr if disabled
+        std::vector<PersistentTValueCache::Hash> m_matrixHashes; // hashes of the generating matrices of the net
+        std::vector<unsigned long> m_hashCalls; // evaluation for which the hash of each generating matrix was computed
+        unsigned long m_numCalls = 0; // number of evaluations with the persistent cache
+
+        // The nodes of the projection tree are stored in contiguous arrays, layer by layer (one layer by dimension, 
+        // with the projections whose highest coordinate is the dimension), in the evaluation order. 
+        std::vector<size_t> m_layerBegin = {0}; // index of the first node of each layer, and total number of nodes
+        std::vector<Real> m_weights; // weight of the projection of each node
+        std::vector<unsigned int> m_cardinals; // cardinal of the projection of each node
+        std::vector<Projection> m_projections; // projection represented by each node
+        std::vector<size_t> m_motherBegin = {0}; // index in m_mothers of the first mother of each node
+        std::vector<size_t> m_mothers; // indices of the subprojections whose cardinal is one less
+        std::vector<size_t> m_sortedNodes; // indices of the nodes of each layer, in increasing order of projections
+        std::vector<SubProjCombination> m_subProjCombinations; // combination of the merits of the subprojections
+        std::vector<MeritStorage> m_meritsMem; // stored merits
+        std::vector<MeritStorage> m_meritsTmp; // temporary merits
+
+        // Adaptive evaluation order and lower bounds used to abort the evaluation of a layer early.
+        std::vector<size_t> m_order; // indices of the nodes of each layer, in the evaluation order (by increasing cardinal)
+        std::vector<unsigned int> m_aborts; // number of abortions caused by each node
+        std::vector<Real> m_lowerBounds; // lower bound on the combined merit of each node
+        std::vector<Real> m_combinedMerits; // combined merit of each node for the last evaluated net
+        std::vector<Real> m_remainingBound; // lower bound on the merits of the nodes after each position of the evaluation order
+        Dimension m_boundsDimension = std::numeric_limits<Dimension>::max(); // dimension of the layer of the bounds
 };
 
 }}
@@ -0,0 +1,87 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * \file
+ * This file contains the definition of the cache of the t-values of projections shared by the evaluators of a combined figure of merit.
+ */ 
+
+#ifndef NET_BUILDER__FIGURE_OF_MERIT__PROJECTION_TVALUE_CACHE_H
+#define NET_BUILDER__FIGURE_OF_MERIT__PROJECTION_TVALUE_CACHE_H
+
+#include "netbuilder/Types.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace NetBuilder { namespace FigureOfMerit {
+
+/** 
+ * Cache of the t-values of the projections of the net being evaluated, shared by the evaluators of the figures 
+ * of a combined figure of merit, so that the t-value of a projection is computed once for all the figures.
+ * The cache is cleared before each net (and each dimension) is evaluated, so that the entries always refer to
+ * the generating matrices of the net being evaluated. The unilevel t-values (of the full generating matrices) and the 
+ * multilevel t-values (one t-value by level) are stored separately.
+ */ 
+class ProjectionTValueCache
+{
+    public:
+
+        /** 
+         * Unilevel entry of the cache: the t-value of a projection, or a lower bound on it if the computation
+         * of the t-value was stopped as soon as the t-value was proven to be too large.
+         */ 
+        struct Bound
+        {
+            unsigned int tValue = 0; // t-value or lower bound on the t-value
+            bool exact = false; // whether tValue is the t-value
+        };
+
+        /** 
+         * Removes all the entries of the cache.
+         */ 
+        void clear()
+        {
+            m_unilevel.clear();
+            m_multilevel.clear();
+        }
+
+        /** 
+         * Returns the unilevel entry of \c projection. A new entry holds a zero lower bound.
+         * @param projection Projection.
+         */ 
+        Bound& unilevel(const Projection& projection)
+        {
+            return m_unilevel[projection];
+        }
+
+        /** 
+         * Returns the multilevel t-values of \c projection. A new entry is empty.
+         * @param projection Projection.
+         */ 
+        std::vector<unsigned int>& multilevel(const Projection& projection)
+        {
+            return m_multilevel[projection];
+        }
+
+    private:
+        std::unordered_map<Projection, Bound> m_unilevel; // unilevel entries
+        std::unordered_map<Projection, std::vector<unsigned int>> m_multilevel; // multilevel entries
+};
+
+}}
+
+#endif
@@ -26,6 +26,48 @@
 
 namespace NetBuilder {
 
+    /**
+     * Lightweight view over the generating matrices of a projection of a digital net.
+     * The view only holds a pointer to an array of pointers to the matrices: neither the matrices nor their rows are copied,
+     * and both must outlive the view.
+     */ 
+    class GeneratingMatricesView
+    {
+        public:
+
+            /**
+             * Constructor.
+             * @param matrices Array of pointers to the generating matrices.
+             * @param size Number of matrices.
+             */ 
+            GeneratingMatricesView(const GeneratingMatrix* const* matrices, unsigned int size):
+                m_matrices(matrices),
+                m_size(size)
+            {};
+
+            /**
+             * Constructs a view over a contiguous container of pointers to generating matrices.
+             * @param matrices Container of pointers to the generating matrices.
+             */ 
+            template <typename CONTAINER>
+            GeneratingMatricesView(const CONTAINER& matrices):
+                GeneratingMatricesView(matrices.data(), (unsigned int) matrices.size())
+            {};
+
+            /** Returns the number of matrices. */
+            unsigned int size() const { return m_size; }
+
+            /** 
+             * Returns the matrix at position \c i.
+             * @param i Position of the matrix.
+             */ 
+            const GeneratingMatrix& operator[](unsigned int i) const { return *m_matrices[i]; }
+
+        private:
+            const GeneratingMatrix* const* m_matrices; // pointers to the matrices
+            unsigned int m_size; // number of matrices
+    };
+
     /**
      * Class to compute the t-value of a projection of a digital net in base 2.
      * This class uses a refined version of the gaussian elimination to compute efficiently the t-value of
@@ -38,20 +80,33 @@ namespace NetBuilder {
         /**
          * Compute the t-value corresponding to the generating matrices \c baseMatrices, using the prior knowledge that the maximum of the
          * t-values of the subprojections is \c maxTValuesSubProj.
-         * @param baseMatrices Generating matrices.
+         * @param baseMatrices View over the generating matrices.
+         * @param maxTValuesSubProj Maximum of the t-value of the subprojections.
+         * @param verbose Verbosity level.
+         */ 
+        static unsigned int computeTValue(GeneratingMatricesView baseMatrices, unsigned int maxTValuesSubProj, int verbose);
+
+        /**
+         * Compute the t-value corresponding to the generating matrices \c baseMatrices if it is not larger than \c tValueBound, using the prior 
+         * knowledge that the maximum of the t-values of the subprojections is \c maxTValuesSubProj. 
+         * The systems with the largest numbers of rows are solved first, so that the computation stops as soon as the t-value is proven to be 
+         * larger than \c tValueBound, without computing it exactly.
+         * @param baseMatrices View over the generating matrices.
          * @param maxTValuesSubProj Maximum of the t-value of the subprojections.
+         * @param tValueBound Largest t-value to compute exactly.
          * @param verbose Verbosity level.
+         * @return The t-value if it is not larger than \c tValueBound, and a lower bound on the t-value larger than \c tValueBound otherwise.
          */ 
-        static unsigned int computeTValue(std::vector<GeneratingMatrix> baseMatrices, unsigned int maxTValuesSubProj, int verbose);
+        static unsigned int computeTValue(GeneratingMatricesView baseMatrices, unsigned int maxTValuesSubProj, unsigned int tValueBound, int verbose);
 
         /**
          * Compute the t-value corresponding to the generating matrices \c baseMatrices, for each level, using the prior knowledge that the maximum of the
          * t-values of the subprojections, for each level \c i is \c maxTValuesSubProj[i].
-         * @param baseMatrices Generating matrices.
+         * @param baseMatrices View over the generating matrices.
          * @param maxTValuesSubProj Maximum of the t-value of the subprojections.
          * @param verbose Verbosity level.
          */ 
-        static std::vector<unsigned int> computeTValue(std::vector<GeneratingMatrix> baseMatrices, const std::vector<unsigned int>& maxTValuesSubProj, int verbose)
+        static std::vector<unsigned int> computeTValue(GeneratingMatricesView baseMatrices, const std::vector<unsigned int>& maxTValuesSubProj, int verbose)
         {
             return computeTValue(baseMatrices, 0, maxTValuesSubProj, verbose);
         };
@@ -59,12 +114,12 @@ namespace NetBuilder {
         /**
          * Compute the t-value corresponding to the generating matrices \c baseMatrices, for each level greater or equal to \c mMin, using the prior knowledge that the maximum of the
          * t-values of the subprojections, for each level <CODE> i + mMin </CODE> is \c maxTValuesSubProj[i]. We do not compute the t-value for the lower levels.
-         * @param baseMatrices Generating matrices.
+         * @param baseMatrices View over the generating matrices.
          * @param mMin Minimul level.
          * @param maxTValuesSubProj Maximum of the t-value of the subprojections.
          * @param verbose Verbosity level.
          */ 
-        static std::vector<unsigned int> computeTValue(std::vector<GeneratingMatrix> baseMatrices, unsigned int mMin, const std::vector<unsigned int>& maxTValuesSubProj, int verbose);
+        static std::vector<unsigned int> computeTValue(GeneratingMatricesView baseMatrices, unsigned int mMin, const std::vector<unsigned int>& maxTValuesSubProj, int verbose);
     };
 
     /**
@@ -77,20 +132,35 @@ namespace NetBuilder {
         /**
          * Compute the t-value corresponding to the generating matrices \c baseMatrices, using the prior knowledge that the maximum of the
          * t-values of the subprojections is \c maxTValuesSubProj.
-         * @param baseMatrices Generating matrices.
+         * @param baseMatrices View over the generating matrices.
+         * @param maxTValuesSubProj Maximum of the t-value of the subprojections.
+         * @param verbose Verbosity level.
+         */ 
+        static unsigned int computeTValue(GeneratingMatricesView baseMatrices, unsigned int maxTValuesSubProj, int verbose);
+
+        /**
+         * Compute the t-value corresponding to the generating matrices \c baseMatrices if it is not larger than \c tValueBound, using the prior 
+         * knowledge that the maximum of the t-values of the subprojections is \c maxTValuesSubProj. 
+         * This method already looks for linear dependences in order of decreasing t-values and stops at the first one, so the bound does not 
+         * shorten the computation: the exact t-value is always returned.
+         * @param baseMatrices View over the generating matrices.
          * @param maxTValuesSubProj Maximum of the t-value of the subprojections.
+         * @param tValueBound Largest t-value to compute exactly.
          * @param verbose Verbosity level.
          */ 
-        static unsigned int computeTValue(std::vector<GeneratingMatrix> baseMatrices, unsigned int maxTValuesSubProj, int verbose);
+        static unsigned int computeTValue(GeneratingMatricesView baseMatrices, unsigned int maxTValuesSubProj, unsigned int tValueBound, int verbose)
+        {
+            return computeTValue(baseMatrices, maxTValuesSubProj, verbose);
+        }
 
         /**
          * Compute the t-value corresponding to the generating matrices \c baseMatrices, for each level, using the prior knowledge that the maximum of the
          * t-values of the subprojections, for each level \c i is \c maxTValuesSubProj[i].
-         * @param baseMatrices Generating matrices.
+         * @param baseMatrices View over the generating matrices.
          * @param maxTValuesSubProj Maximum of the t-value of the subprojections.
          * @param verbose Verbosity level.
          */ 
-        static std::vector<unsigned int> computeTValue(std::vector<GeneratingMatrix> baseMatrices, const std::vector<unsigned int>& maxTValuesSubProj, int verbose);
+        static std::vector<unsigned int> computeTValue(GeneratingMatricesView baseMatrices, const std::vector<unsigned int>& maxTValuesSubProj, int verbose);
     };
 
 }
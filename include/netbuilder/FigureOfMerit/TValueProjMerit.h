@@ -22,6 +22,8 @@
 #include "netbuilder/FigureOfMerit/TValueComputation.h"
 #include "netbuilder/FigureOfMerit/LevelCombiner.h"
 
+#include <boost/container/small_vector.hpp>
+
 #include <functional>
 #include <stdexcept>
 
@@ -29,6 +31,26 @@ namespace NetBuilder { namespace FigureOfMerit {
 
 using LatticeTester::Coordinates;
 
+namespace detail {
+    /// Pointers to the generating matrices of a projection, stored inline for projections of moderate order.
+    typedef boost::container::small_vector<const GeneratingMatrix*, 16> ProjectionMatrices;
+
+    /**
+     * Returns pointers to the generating matrices of \c net for the coordinates in \c projection, without copying the matrices.
+     * @param net Digital net.
+     * @param projection Projection.
+     */ 
+    inline ProjectionMatrices projectionMatrices(const AbstractDigitalNet& net, const Projection& projection)
+    {
+        ProjectionMatrices mats;
+        for(auto dim : projection)
+        {
+            mats.push_back(&net.generatingMatrix(dim));
+        }
+        return mats;
+    }
+}
+
 /** Template class representing a projection-dependent merit defined by the t-value of the projection.
  *  @tparam ET Embedding type : UNILEVEL or MULTILEVEL.
  *  @tparam METHOD Computation method of the t-value. 
@@ -86,21 +108,113 @@ class TValueProjMerit<EmbeddingType::UNILEVEL, METHOD>
          * @param projection Projection to use.
          * @param maxMeritsSubProj Maximum of the t-value of the subprojections. 
          */ 
-        Real operator()(const AbstractDigitalNet& net , const LatticeTester::Coordinates& projection, SubProjCombination maxMeritsSubProj) const 
+        Real operator()(const AbstractDigitalNet& net , const Projection& projection, SubProjCombination maxMeritsSubProj) const 
+        {
+            return METHOD::computeTValue(detail::projectionMatrices(net, projection), maxMeritsSubProj, false);
+        }
+
+        /** 
+         * Computes the projection-dependent merit of the net \c net for the given projection if its combined merit is accepted by \c accept.
+         * Otherwise, the computation of the t-value stops as soon as it is proven to be too large and a t-value whose combined merit
+         * is rejected by \c accept is returned.
+         * The largest accepted t-value is found by bisection, which assumes that the combined merit is nondecreasing in the t-value.
+         * @param net Digital net to evaluate.
+         * @param projection Projection to use.
+         * @param maxMeritsSubProj Maximum of the t-value of the subprojections. 
+         * @param accept Predicate which accepts the combined merits below some threshold.
+         */ 
+        template <typename ACCEPT>
+        Merit operator()(const AbstractDigitalNet& net , const Projection& projection, SubProjCombination maxMeritsSubProj, const ACCEPT& accept)
+        {
+            const unsigned int nCols = net.numColumns();
+            const unsigned int s = (unsigned int) projection.size();
+            if (s < 2 || s > nCols)
+            {
+                return (Merit) (*this)(net, projection, maxMeritsSubProj);
+            }
+
+            // the t-value lies between maxMeritsSubProj and max(maxMeritsSubProj, nCols-s+1)
+            unsigned int accepted = maxMeritsSubProj;
+            unsigned int rejected = std::max(maxMeritsSubProj, nCols-s+1);
+            if (accept(combine(rejected, net, projection)))
+            {
+                return (Merit) (*this)(net, projection, maxMeritsSubProj);
+            }
+            if (!accept(combine(accepted, net, projection)))
+            {
+                return accepted;
+            }
+            while (rejected - accepted > 1)
+            {
+                const unsigned int t = accepted + (rejected - accepted) / 2;
+                if (accept(combine(t, net, projection)))
+                {
+                    accepted = t;
+                }
+                else
+                {
+                    rejected = t;
+                }
+            }
+            return METHOD::computeTValue(detail::projectionMatrices(net, projection), maxMeritsSubProj, accepted, false);
+        }
+
+        /** 
+         * Computes the projection-dependent merit of the net \c net for the given projection as the previous function,
+         * using the t-values of the projections of the same net which are shared with other evaluators through \c cache.
+         * A t-value or a lower bound on the t-value which is known to be rejected is returned directly, 
+         * and the t-value computed otherwise is stored in the cache.
+         * @param net Digital net to evaluate.
+         * @param projection Projection to use.
+         * @param maxMeritsSubProj Maximum of the t-value of the subprojections. 
+         * @param accept Predicate which accepts the combined merits below some threshold.
+         * @param cache Cache of the t-values of the projections of \c net.
+         */ 
+        template <typename ACCEPT>
+        Merit operator()(const AbstractDigitalNet& net , const Projection& projection, SubProjCombination maxMeritsSubProj, const ACCEPT& accept, ProjectionTValueCache& cache)
         {
-            std::vector<GeneratingMatrix> mats;
-            for(auto dim : projection)
+            ProjectionTValueCache::Bound& entry = cache.unilevel(projection);
+            if (entry.exact)
+            {
+                return entry.tValue;
+            }
+            if (entry.tValue > maxMeritsSubProj) // better lower bound
             {
-                mats.push_back(net.generatingMatrix(dim));
+                if (!accept(combine(entry.tValue, net, projection)))
+                {
+                    return entry.tValue;
+                }
+                maxMeritsSubProj = entry.tValue;
             }
-            return METHOD::computeTValue(std::move(mats),maxMeritsSubProj, false);
+            const Merit tValue = (*this)(net, projection, maxMeritsSubProj, accept);
+            entry.tValue = tValue;
+            entry.exact = accept(combine(tValue, net, projection)); // an accepted t-value is exact
+            return tValue;
         }
 
-        virtual Real combine(Merit merit, const AbstractDigitalNet& net, const LatticeTester::Coordinates& projection)
+        /** 
+         * Combines the t-value \c merit in a single value merit. Must be nondecreasing in the t-value.
+         * @param merit t-value.
+         * @param net Digital net.
+         * @param projection Projection.
+         */ 
+        virtual Real combine(Merit merit, const AbstractDigitalNet& net, const Projection& projection)
         {
             return (Real) merit;
         }
 
+        /** 
+         * Returns a lower bound on the combined merit of a projection, knowing the combination \c maxMeritsSubProj of the t-values
+         * of some of its subprojections. The t-value of a projection is at least the t-value of its subprojections.
+         * @param maxMeritsSubProj Maximum of the t-value of the subprojections. 
+         * @param net Digital net.
+         * @param projection Projection.
+         */ 
+        Real meritLowerBound(SubProjCombination maxMeritsSubProj, const AbstractDigitalNet& net, const Projection& projection)
+        {
+            return combine(maxMeritsSubProj, net, projection);
+        }
+
         /** Updates the combination of merit \c subProjCombination using \c merit.
          * @param merit Merit used to update.
          * @param subProjCombination  Combination of merit to update. 
@@ -198,14 +312,43 @@ class TValueProjMerit<EmbeddingType::MULTILEVEL, METHOD>
          * @param projection is the projection to consider
          * @param maxMeritsSubProj is the maximal merit of the subprojections
          */ 
-        std::vector<unsigned int> operator()(const AbstractDigitalNet& net, const LatticeTester::Coordinates& projection, const std::vector<unsigned int>& maxMeritsSubProj) const 
+        std::vector<unsigned int> operator()(const AbstractDigitalNet& net, const Projection& projection, const std::vector<unsigned int>& maxMeritsSubProj) const 
+        {
+            return METHOD::computeTValue(detail::projectionMatrices(net, projection), maxMeritsSubProj, 0);
+        }
+
+        /** 
+         * Computes the projection-dependent multilevel merits of the net for the given projection. 
+         * The merits of the levels are not bounded separately by the combined merit, so the predicate is not used.
+         * @param net is the digital net for which we want to compute the merit
+         * @param projection is the projection to consider
+         * @param maxMeritsSubProj is the maximal merit of the subprojections
+         * @param accept Predicate which accepts the combined merits below some threshold (not used).
+         */ 
+        template <typename ACCEPT>
+        std::vector<unsigned int> operator()(const AbstractDigitalNet& net, const Projection& projection, const std::vector<unsigned int>& maxMeritsSubProj, const ACCEPT& accept) const 
+        {
+            return (*this)(net, projection, maxMeritsSubProj);
+        }
+
+        /** 
+         * Computes the projection-dependent multilevel merits of the net for the given projection as the previous function,
+         * using the t-values of the projections of the same net which are shared with other evaluators through \c cache.
+         * @param net is the digital net for which we want to compute the merit
+         * @param projection is the projection to consider
+         * @param maxMeritsSubProj is the maximal merit of the subprojections
+         * @param accept Predicate which accepts the combined merits below some threshold (not used).
+         * @param cache Cache of the t-values of the projections of \c net.
+         */ 
+        template <typename ACCEPT>
+        std::vector<unsigned int> operator()(const AbstractDigitalNet& net, const Projection& projection, const std::vector<unsigned int>& maxMeritsSubProj, const ACCEPT& accept, ProjectionTValueCache& cache) const 
         {
-            std::vector<GeneratingMatrix> mats;
-            for(auto dim : projection)
+            std::vector<unsigned int>& entry = cache.multilevel(projection);
+            if (entry.empty())
             {
-                mats.push_back(net.generatingMatrix(dim));
+                entry = (*this)(net, projection, maxMeritsSubProj);
             }
-            return METHOD::computeTValue(std::move(mats), maxMeritsSubProj, 0);
+            return entry;
         }
 
         /** 
@@ -214,7 +357,7 @@ class TValueProjMerit<EmbeddingType::MULTILEVEL, METHOD>
          * @param net Digital net.
          * @param projection Projection.
          */ 
-        virtual Real combine(const Merit& merits, const AbstractDigitalNet& net, const LatticeTester::Coordinates& projection) {
+        virtual Real combine(const Merit& merits, const AbstractDigitalNet& net, const Projection& projection) {
             RealVector tmp(merits.size());
             for (unsigned int i=0; i<merits.size(); i++){
                 tmp[i] = (Real) merits[i];
@@ -222,6 +365,18 @@ class TValueProjMerit<EmbeddingType::MULTILEVEL, METHOD>
             return (*m_combiner)(std::move(tmp)) ; 
         }
 
+        /** 
+         * Returns a lower bound on the combined merit of a projection. The combiner of the levels is not assumed
+         * to be monotone, so the bound is zero.
+         * @param maxMeritsSubProj Maximum of the t-value of the subprojections (not used). 
+         * @param net Digital net (not used).
+         * @param projection Projection (not used).
+         */ 
+        Real meritLowerBound(const SubProjCombination& maxMeritsSubProj, const AbstractDigitalNet& net, const Projection& projection) const
+        {
+            return 0;
+        }
+
         /** Updates the combination of merit \c subProjCombination using \c merit.
          * @param merit Merit used to update.
          * @param subProjCombination  Combination of merit to update. 
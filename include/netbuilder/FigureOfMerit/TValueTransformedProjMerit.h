@@ -93,7 +93,11 @@ class TValueTransformedProjMerit<EmbeddingType::UNILEVEL, METHOD>: public TValue
             this->cost_function = cost_function;
         }
 
-        virtual Real combine(Merit merit, const AbstractDigitalNet& net, const LatticeTester::Coordinates& projection)
+        /** 
+         * Transforms the t-value \c merit. Both transformations are nondecreasing in the t-value 
+         * for t-values up to \f$m - |\mathfrak{u}| + 1\f$, which bounds the t-value of a projection of order at least two.
+         */ 
+        virtual Real combine(Merit merit, const AbstractDigitalNet& net, const Projection& projection)
         {
             return h(merit, net.numColumns(), projection.size(), cost_function);
         }
@@ -137,7 +141,7 @@ class TValueTransformedProjMerit<EmbeddingType::MULTILEVEL, METHOD>: public TVal
             this->cost_function = cost_function;
         }
 
-        virtual Real combine(const Merit& merits, const AbstractDigitalNet& net, const LatticeTester::Coordinates& projection) {
+        virtual Real combine(const Merit& merits, const AbstractDigitalNet& net, const Projection& projection) {
             RealVector tmp(merits.size());
             for (unsigned int i=0; i<merits.size(); i++){
                 tmp[i] = h(merits[i], net.numColumns(), projection.size(), cost_function);
@@ -104,10 +104,10 @@ class GeneratingMatrix {
         void flip(unsigned int i, unsigned int j);
          
 
-        /** Returns the row at position \c i of the matrix.
+        /** Returns a const reference to the row at position \c i of the matrix.
          * @param i Position of the row.
          */ 
-        Row operator[](unsigned int i) const;
+        const Row& operator[](unsigned int i) const;
 
         /** Returns a reference to the row at position \c i of the matrix.
          * @param i Position of the row.
@@ -0,0 +1,105 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * \file
+ * This file contains a class which computes the coordinate-uniform inner products
+ * for all the candidate polynomials of a polynomial net at once.
+ */ 
+
+#ifndef NETBUILDER__CYCLIC_INNER_PROD_H
+#define NETBUILDER__CYCLIC_INNER_PROD_H
+
+#include "netbuilder/Types.h"
+#include "netbuilder/GeneratingMatrix.h"
+
+#include "latbuilder/fftw++.h"
+
+#include <vector>
+
+namespace NetBuilder {
+
+/**
+ * Class used to compute, with a single FFT, the inner products of a weighted state with the
+ * kernel values permuted by the generating matrices of all the polynomials modulo \f$P(z)\f$.
+ * 
+ * The generating matrix of the polynomial \f$q(z)\f$ maps the point with digits \f$h(z)\f$ to the
+ * digits of \f$h(z) q(z) / P(z)\f$. When \f$P(z)\f$ of degree \f$m\f$ is irreducible, the nonzero
+ * residues modulo \f$P(z)\f$ form a cyclic group of order \f$2^m - 1\f$. Writing 
+ * \f$h(z) = \alpha(z)^s\f$ and \f$q(z) = \alpha(z)^t\f$ for a primitive element \f$\alpha(z)\f$, 
+ * the inner products for all \f$q(z)\f$ form a cyclic correlation of length \f$2^m - 1\f$, as for
+ * the fast CBC construction of polynomial lattice rules. 
+ */ 
+class CyclicInnerProd
+{
+    public:
+        /**
+         * Default constructor. The instance is not valid until init() succeeds.
+         */ 
+        CyclicInnerProd();
+
+        /**
+         * Prepares the transforms for modulus \c modulus.
+         * @param modulus Modulus of the polynomial net.
+         * @param kernelValues Kernel values at the points of the net, indexed as in unilevel digital storage.
+         * @return \c false if \c modulus is not irreducible, in which case the instance cannot be used.
+         */ 
+        bool init(const Polynomial& modulus, const RealVector& kernelValues);
+
+        /**
+         * Returns whether the last call to init() succeeded.
+         */ 
+        bool isValid() const { return m_valid; }
+
+        /**
+         * Returns the modulus given to init(), as an integer.
+         */ 
+        uInteger modulus() const { return m_modulus; }
+
+        /**
+         * Computes the inner products of \c state with the permuted kernel values for all the
+         * polynomials coprime with the modulus.
+         * @param state Weighted state, indexed as in unilevel digital storage.
+         */ 
+        void computeProducts(const RealVector& state);
+
+        /**
+         * Returns the inner product computed by the last call to computeProducts() for the
+         * polynomial whose generating matrix is \c matrix.
+         */ 
+        Real product(const GeneratingMatrix& matrix) const;
+
+    private:
+        typedef fftw<Real>::inplace_transform FFTWorkspace;
+        typedef fftw<Real>::complex_vector FFTComplexVector;
+
+        uInteger multiplyMod(uInteger a, uInteger b) const;
+        uInteger powerMod(uInteger a, uInteger exponent) const;
+
+        bool m_valid;
+        uInteger m_modulus; // modulus as an integer
+        unsigned int m_degree; // degree of the modulus
+        Real m_kernelZero; // kernel value at the origin
+        std::vector<uInteger> m_stateIndex; // state index of the point with digits alpha^s
+        std::vector<uInteger> m_kernelLog; // discrete logarithm of the residue mapped to each kernel index
+        FFTComplexVector m_kernelFFT; // FFT of the kernel values permuted by the powers of alpha
+        std::vector<FFTWorkspace> m_workspace; // transform buffer (empty until init() succeeds)
+        std::vector<Real> m_products; // inner products indexed by discrete logarithm
+};
+
+}
+
+#endif
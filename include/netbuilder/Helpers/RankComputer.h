@@ -24,9 +24,9 @@
 
 #include "netbuilder/GeneratingMatrix.h"
 
+#include <limits>
 #include <map>
-#include <set>
-#include <list>
+#include <vector>
 
 // #define DEBUG_ROW_REDUCER
 
@@ -34,6 +34,9 @@ namespace NetBuilder {
 
 /**
  * Class used to perform row reduction operations on a matrix.
+ * 
+ * The positions of the pivots are stored in flat tables indexed by rows and by columns, and the rows are reduced in place,
+ * so that replacing a row does not allocate memory.
  */ 
 class RankComputer
 {
@@ -55,6 +58,12 @@ class RankComputer
          */ 
         void addRow(GeneratingMatrix newRow);
 
+        /**
+         * Adds a row below the current matrix and updates the reduction subsequently.
+         * @param newRow The row to stack below. Must have numCols() elements.
+         */ 
+        void addRow(const GeneratingMatrix::Row& newRow);
+
         /**
          * Adds a column on the right to the current matrix and updates the reduction subsequently.
          * @param newCol The one-column matrix to stack on the right.
@@ -69,6 +78,14 @@ class RankComputer
          */ 
         void replaceRow(unsigned int rowIndex, GeneratingMatrix&& newRow, int verbose = 0);
 
+        /**
+         * Replaces the row in position \c rowIndex by \c newRow.
+         * @param rowIndex Index of the row to discard.
+         * @param newRow Replacement row. Must have numCols() elements.
+         * @param verbose Verbosity level.
+         */ 
+        void replaceRow(unsigned int rowIndex, const GeneratingMatrix::Row& newRow, int verbose = 0);
+
         /** 
          * Computes the rank of the matrix.
          */ 
@@ -110,7 +127,7 @@ class RankComputer
         /**
          * Returns a map of pivot positions (key: row index, value: column index).
          */ 
-        std::map<unsigned int, unsigned int> getPivots() const {return m_pivotsRowColPositions; }
+        std::map<unsigned int, unsigned int> getPivots() const;
 
         /**
          * Check if a matrix is invertible. Returns false if the matrix is not-square or singular, 
@@ -131,10 +148,10 @@ class RankComputer
         unsigned int m_smallestFullRank; // minimal number of columns necessary for the system spanned by the rows to be full-rank.
         GeneratingMatrix m_redMat; // row-reduced matrix
         GeneratingMatrix m_rowOperations; // row operations matrix
-        std::map<unsigned int, unsigned int> m_pivotsColRowPositions; // columns index are the keys and rows indexes are the values
-        std::map<unsigned int, unsigned int> m_pivotsRowColPositions; // columns index are the keys and rows indexes are the values
-        std::set<unsigned int> m_columnsWithoutPivot; // ordered set for columns without a pivot
-        std::list<unsigned int> m_rowsWithoutPivot; // list of rows without a pivot 
+        static constexpr unsigned int NoPivot = std::numeric_limits<unsigned int>::max(); // marks rows and columns without a pivot
+        unsigned int m_rank = 0; // number of pivots
+        std::vector<unsigned int> m_pivotRowOfCol; // row index of the pivot of each column, or NoPivot
+        std::vector<unsigned int> m_pivotColOfRow; // column index of the pivot of each row, or NoPivot
         #ifdef DEBUG_ROW_REDUCER
         GeneratingMatrix m_baseMatrix;
         #endif
@@ -22,8 +22,10 @@
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/join.hpp>
 #include <boost/algorithm/string/replace.hpp>
+#include <boost/algorithm/string/trim.hpp>
 #include <boost/lexical_cast.hpp>
 #include <fstream>
+#include <iostream>
 
 #include "netbuilder/Types.h"
 #include "netbuilder/Parser/NetDescriptionParser.h"
@@ -33,6 +35,7 @@
 #include "netbuilder/Task/Task.h"
 #include "netbuilder/Task/CBCSearch.h"
 #include "netbuilder/Task/Eval.h"
+#include "netbuilder/Task/BatchEval.h"
 #include "netbuilder/Task/ExhaustiveSearch.h"
 #include "netbuilder/Task/RandomSearch.h"
 #include "netbuilder/Task/FullCBCExplorer.h"
@@ -110,6 +113,67 @@ struct ExplorationMethodParser
             auto net = std::make_unique<DigitalNet<NC>>(commandLine.m_dimension, commandLine.m_sizeParameter, std::move(genValues));
             return std::make_unique<Task::Eval>(std::move(net), std::move(commandLine.m_figure), commandLine.m_verbose);
         }
+        else if (name == "batch-evaluation"){
+            if (explorationDescriptionStrings.size() != 2)
+            {
+                throw BadExplorationMethod("file of net descriptions is not correctly specified; see --help");
+            }
+            // the descriptions are read from the standard input if the file name is -
+            const bool fromStdin = explorationDescriptionStrings[1] == "-";
+            std::ifstream file;
+            if (!fromStdin)
+            {
+                file.open(explorationDescriptionStrings[1]);
+                if (!file)
+                {
+                    throw BadExplorationMethod("cannot open " + explorationDescriptionStrings[1]);
+                }
+            }
+            std::istream& input = fromStdin ? std::cin : file;
+
+            // nets are separated by comment lines (starting with #) or by blank lines;
+            // trailing comments are stripped from the other lines
+            std::vector<std::unique_ptr<AbstractDigitalNet>> nets;
+            std::vector<std::string> netLines;
+            auto addNet = [&] ()
+            {
+                if (netLines.empty())
+                {
+                    return;
+                }
+                std::string netDescritionString = boost::algorithm::join(netLines, "-");
+                boost::replace_all(netDescritionString, " ", ",");
+                auto genValues = NetDescriptionParser<NC,ET>::parse(commandLine, netDescritionString);
+                nets.push_back(std::make_unique<DigitalNet<NC>>(commandLine.m_dimension, commandLine.m_sizeParameter, std::move(genValues)));
+                netLines.clear();
+            };
+            std::string line;
+            while (std::getline(input, line))
+            {
+                boost::algorithm::erase_all(line, "\r");
+                if (line.empty() || line[0] == '#' || line.find_first_not_of(" \t") == std::string::npos)
+                {
+                    addNet();
+                    continue;
+                }
+                const auto comment = line.find('#');
+                if (comment != std::string::npos)
+                {
+                    line.erase(comment);
+                }
+                boost::algorithm::trim(line);
+                if (!line.empty())
+                {
+                    netLines.push_back(line);
+                }
+            }
+            addNet();
+            if (nets.empty())
+            {
+                throw BadExplorationMethod("no net description found in " + (fromStdin ? std::string("the standard input") : explorationDescriptionStrings[1]));
+            }
+            return std::make_unique<Task::BatchEval>(std::move(nets), std::move(commandLine.m_figure), commandLine.m_verbose);
+        }
         else if (name == "exhaustive"){
             return std::make_unique<Task::ExhaustiveSearch<NC, ET>>(commandLine.m_dimension,
                                                         commandLine.m_sizeParameter,
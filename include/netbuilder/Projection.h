@@ -0,0 +1,219 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * \file
+ * Compact representation of projections.
+ */
+
+#ifndef NETBUILDER__PROJECTION_H
+#define NETBUILDER__PROJECTION_H
+
+#include "latticetester/Coordinates.h"
+
+#include <boost/container/small_vector.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <ostream>
+
+namespace NetBuilder {
+
+/**
+ * Projection, that is, a set of coordinates.
+ *
+ * The coordinates are kept sorted in increasing order in a small array with
+ * inline storage, so that projections of order up to #InlineSize are
+ * created, copied and iterated over without any memory allocation, unlike
+ * LatticeTester::Coordinates, which is a \c std::set.  Projections are used
+ * in the projection tree of the projection-dependent evaluator and in the
+ * t-value caches; conversion to and from LatticeTester::Coordinates happens
+ * only at the boundaries with LatticeTester (for instance, for the weights).
+ */
+class Projection {
+public:
+    /// Type of a coordinate.
+    typedef unsigned int value_type;
+
+    /// Number of coordinates stored without memory allocation.
+    static constexpr std::size_t InlineSize = 6;
+
+    typedef boost::container::small_vector<value_type, InlineSize> container_type;
+    typedef container_type::const_iterator const_iterator;
+    typedef container_type::const_iterator iterator;
+    typedef container_type::const_reverse_iterator const_reverse_iterator;
+    typedef container_type::size_type size_type;
+
+    /**
+     * Constructs an empty projection.
+     */
+    Projection() = default;
+
+    /**
+     * Constructs a projection with the coordinates in \c coords, which need
+     * not be sorted.
+     */
+    Projection(std::initializer_list<value_type> coords):
+        m_coords(coords)
+    { normalize(); }
+
+    /**
+     * Constructs a projection from a set of coordinates.
+     */
+    explicit Projection(const LatticeTester::Coordinates& coords)
+    {
+        m_coords.reserve(coords.size());
+        for (const auto coord : coords)
+            m_coords.push_back(static_cast<value_type>(coord));
+    }
+
+    /**
+     * Returns the projection as a set of coordinates.
+     */
+    LatticeTester::Coordinates coordinates() const
+    {
+        LatticeTester::Coordinates coords;
+        for (const auto coord : m_coords)
+            coords.insert(coords.end(), coord);
+        return coords;
+    }
+
+    size_type size() const
+    { return m_coords.size(); }
+
+    bool empty() const
+    { return m_coords.empty(); }
+
+    const_iterator begin() const
+    { return m_coords.begin(); }
+
+    const_iterator end() const
+    { return m_coords.end(); }
+
+    const_reverse_iterator rbegin() const
+    { return m_coords.rbegin(); }
+
+    const_reverse_iterator rend() const
+    { return m_coords.rend(); }
+
+    /**
+     * Returns the largest coordinate.
+     */
+    value_type back() const
+    { return m_coords.back(); }
+
+    /**
+     * Returns \c true if \c coord belongs to the projection.
+     */
+    bool contains(value_type coord) const
+    { return std::binary_search(m_coords.begin(), m_coords.end(), coord); }
+
+    /**
+     * Adds coordinate \c coord to the projection, if it is not already there.
+     */
+    void insert(value_type coord)
+    {
+        auto it = std::lower_bound(m_coords.begin(), m_coords.end(), coord);
+        if (it == m_coords.end() || *it != coord)
+            m_coords.insert(it, coord);
+    }
+
+    /**
+     * Removes coordinate \c coord from the projection, if it is there.
+     */
+    void erase(value_type coord)
+    {
+        auto it = std::lower_bound(m_coords.begin(), m_coords.end(), coord);
+        if (it != m_coords.end() && *it == coord)
+            m_coords.erase(it);
+    }
+
+    /**
+     * Returns a copy of the projection with coordinate \c coord added.
+     */
+    Projection with(value_type coord) const
+    {
+        Projection res(*this);
+        res.insert(coord);
+        return res;
+    }
+
+    /**
+     * Returns a copy of the projection with coordinate \c coord removed.
+     */
+    Projection without(value_type coord) const
+    {
+        Projection res(*this);
+        res.erase(coord);
+        return res;
+    }
+
+    /**
+     * Returns a hash value of the projection.
+     */
+    std::size_t hash() const
+    { return boost::hash_range(m_coords.begin(), m_coords.end()); }
+
+    bool operator==(const Projection& other) const
+    { return m_coords == other.m_coords; }
+
+    bool operator!=(const Projection& other) const
+    { return m_coords != other.m_coords; }
+
+    /**
+     * Lexicographic order, as for LatticeTester::Coordinates.
+     */
+    bool operator<(const Projection& other) const
+    { return m_coords < other.m_coords; }
+
+private:
+    container_type m_coords;
+
+    void normalize()
+    {
+        std::sort(m_coords.begin(), m_coords.end());
+        m_coords.erase(std::unique(m_coords.begin(), m_coords.end()), m_coords.end());
+    }
+};
+
+/**
+ * Formats the projection as a set of coordinates, for instance <tt>{0,2,5}</tt>.
+ */
+inline std::ostream& operator<<(std::ostream& os, const Projection& projection)
+{
+    os << "{";
+    bool first = true;
+    for (const auto coord : projection) {
+        os << (first ? "" : ",") << coord;
+        first = false;
+    }
+    return os << "}";
+}
+
+}
+
+namespace std {
+    template <>
+    struct hash<NetBuilder::Projection> {
+        size_t operator()(const NetBuilder::Projection& projection) const
+        { return projection.hash(); }
+    };
+}
+
+#endif
@@ -0,0 +1,196 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NETBUILDER__TASK__BATCH_EVAL_H
+#define NETBUILDER__TASK__BATCH_EVAL_H
+
+#include "netbuilder/Types.h"
+
+#include "netbuilder/Task/Task.h"
+#include "netbuilder/FigureOfMerit/FigureOfMerit.h"
+
+#include "latbuilder/Parallel.h"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace NetBuilder { namespace Task {
+
+/**
+ * Evaluation of a figure of merit for many nets.
+ *
+ * The nets are distributed across threads.  Each thread creates a single
+ * evaluator and uses it for all the nets it evaluates, so that the setup of
+ * the figure of merit is done once per thread instead of once per net.
+ * The data which do not depend on the net, such as the kernel values of
+ * coordinate-uniform figures, are computed once by the figure of merit and
+ * shared read-only by the evaluators; only the states are per thread.
+ * The merit values are output as a table, in the order of the nets.
+ */
+class BatchEval : public Task 
+{
+    public:
+
+        /**
+         * Constructor.
+         * @param nets Nets to evaluate.
+         * @param figure Figure of merit.
+         * @param verbose Verbosity level.
+         */
+        BatchEval(std::vector<std::unique_ptr<AbstractDigitalNet>> nets, std::unique_ptr<FigureOfMerit::FigureOfMerit> figure, int verbose = 0):
+            m_nets(std::move(nets)),
+            m_merits(m_nets.size(), 0),
+            m_figure(std::move(figure)),
+            m_verbose(verbose)
+        {
+            if (m_nets.empty())
+            {
+                throw std::runtime_error("BatchEval: no net to evaluate");
+            }
+        }
+
+        BatchEval(BatchEval&&) = default;
+
+        ~BatchEval() = default;
+
+        /**
+        * Returns the dimension.
+        */
+        Dimension dimension() const
+        { return m_nets.front()->dimension(); }
+
+        /**
+        * Returns the number of nets.
+        */
+        size_t numNets() const
+        { return m_nets.size(); }
+
+        /**
+        * Returns the net with index \c i.
+        */
+        const AbstractDigitalNet& net(size_t i) const
+        { return *m_nets[i]; }
+
+        /**
+        * Returns the merit values of the nets, in the same order as the nets.
+        */
+        const std::vector<Real>& meritValues() const
+        { return m_merits; }
+
+        /**
+        * Returns the table of the merit values, with one line per net.
+        */
+        virtual std::string outputNet(OutputStyle outputStyle, unsigned int interlacingFactor) const 
+        {
+            std::ostringstream stream;
+            stream.precision(std::cout.precision());
+            stream << "# net\tmerit" << std::endl;
+            for (size_t i = 0; i < m_nets.size(); ++i)
+            {
+                stream << i + 1 << "\t" << m_merits[i] << std::endl;
+            }
+            stream << "# best net: " << bestIndex() + 1 << std::endl;
+            stream << m_nets[bestIndex()]->format(outputStyle, interlacingFactor);
+            return stream.str();
+        }
+
+        /**
+         *  Returns information about the task
+         */
+        virtual std::string format() const 
+        {
+            std::ostringstream stream;
+            stream << "Task: NetBuilder Batch Evaluation" << std::endl;
+            stream << "Number of components: " << this->dimension() << std::endl;
+            stream << "Number of nets: " << m_nets.size() << std::endl;
+            stream << "Figure of merit: " << m_figure->format() << std::endl;
+            return stream.str();
+        }
+
+        /**
+        * Returns the best merit value among the evaluated nets.
+        */
+        virtual Real outputMeritValue() const 
+        { return m_merits[bestIndex()]; }
+
+        /**
+        * Evaluates all the nets.
+        */
+        virtual void execute()
+        {
+            const long numNets = static_cast<long>(m_nets.size());
+            const int numThreads = std::max(1, std::min<int>(LatBuilder::maxThreads(), numNets));
+
+            // evaluators are created sequentially: the figure of merit is shared
+            std::vector<std::unique_ptr<FigureOfMerit::FigureOfMeritEvaluator>> evaluators;
+            for (int t = 0; t < numThreads; ++t)
+            {
+                evaluators.push_back(m_figure->evaluator());
+            }
+
+            // exceptions cannot leave a parallel region: the first one is rethrown after it
+            std::exception_ptr error;
+            #pragma omp parallel for schedule(dynamic, 1) num_threads(numThreads)
+            for (long i = 0; i < numNets; ++i)
+            {
+                try
+                {
+                    m_merits[i] = evaluators[LatBuilder::threadNum()]->operator()(*m_nets[i]);
+                }
+                catch (...)
+                {
+                    #pragma omp critical
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+                }
+            }
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+
+            if (m_verbose > 0)
+            {
+                std::cout << "Evaluated " << numNets << " nets" << std::endl;
+            }
+        }
+
+        virtual void reset()
+        {
+            std::fill(m_merits.begin(), m_merits.end(), 0);
+        }
+
+    private:
+
+        std::vector<std::unique_ptr<AbstractDigitalNet>> m_nets;
+        std::vector<Real> m_merits;
+        std::unique_ptr<FigureOfMerit::FigureOfMerit> m_figure;
+        int m_verbose;
+
+        size_t bestIndex() const
+        { return std::min_element(m_merits.begin(), m_merits.end()) - m_merits.begin(); }
+};
+
+}}
+
+#endif
@@ -28,6 +28,7 @@
 #include <NTL/GF2X.h>
 #include <NTL/ZZX.h>
 #include "latbuilder/Types.h"
+#include "netbuilder/Projection.h"
 
 
 namespace NetBuilder
@@ -44,7 +45,7 @@ typedef unsigned long uInteger;
 typedef double Real;
 
 /// Vector of floating-point values.
-typedef boost::numeric::ublas::vector<Real> RealVector;
+typedef LatBuilder::RealVector RealVector;
 
 /// Merit value type.
 typedef Real MeritValue;
@@ -0,0 +1,106 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * \file
+ * Compiled tables of projection weights.
+ */
+
+#ifndef NETBUILDER__WEIGHT_TABLE_H
+#define NETBUILDER__WEIGHT_TABLE_H
+
+#include "netbuilder/Types.h"
+#include "netbuilder/Projection.h"
+
+#include "latticetester/Weights.h"
+
+#include <utility>
+#include <vector>
+
+namespace NetBuilder {
+
+/**
+ * Compiled table of the nonzero projection weights.
+ *
+ * For each coordinate \f$j\f$, the table enumerates once all projections
+ * \f$\mathfrak u\f$ with largest coordinate \f$j\f$, of cardinal at most
+ * maxCardinal() and with a nonzero weight, and stores them with their weights
+ * in an array sorted by projection.  Looking up a weight is then a binary
+ * search in that array instead of a virtual call to
+ * LatticeTester::Weights::getWeight(), which works on \c std::set based
+ * coordinates and, for combined weights, queries every component.
+ *
+ * The candidate projections are derived from the structure of the weights
+ * whenever possible, so that projections with a zero weight are not even
+ * enumerated: the explicit projections of projection-dependent weights, and
+ * only the coordinates and orders with nonzero weights for product,
+ * order-dependent, POD and interlaced POD weights.  Combined weights use the
+ * union of the candidates of their components.  Other types of weights fall
+ * back to the enumeration of all projections up to maxCardinal().
+ *
+ * The layers of the table are compiled on demand, so that a table must not be
+ * shared between threads.
+ */
+class WeightTable {
+public:
+    /// Projection with its weight.
+    typedef std::pair<Projection, Real> Entry;
+
+    /// Entries with the same largest coordinate, sorted by projection.
+    typedef std::vector<Entry> Layer;
+
+    /**
+     * Constructor.
+     *
+     * \param weights       Weights to compile.  The table keeps a reference to
+     *                      them.
+     * \param maxCardinal   Maximal cardinal of the projections in the table.
+     */
+    WeightTable(const LatticeTester::Weights& weights, unsigned int maxCardinal);
+
+    const LatticeTester::Weights& weights() const
+    { return m_weights; }
+
+    unsigned int maxCardinal() const
+    { return m_maxCardinal; }
+
+    /**
+     * Returns the projections with largest coordinate \c coordinate, of
+     * cardinal at most maxCardinal() and with a nonzero weight, sorted by
+     * projection.
+     */
+    const Layer& layer(Dimension coordinate);
+
+    /**
+     * Returns the weight of \c projection.
+     *
+     * Projections of cardinal larger than maxCardinal() are looked up in the
+     * original weights.
+     */
+    Real weight(const Projection& projection);
+
+private:
+    const LatticeTester::Weights& m_weights;
+    unsigned int m_maxCardinal;
+    std::vector<Layer> m_layers;
+    std::vector<bool> m_compiled;
+
+    void compile(Dimension coordinate);
+};
+
+}
+
+#endif
@@ -17,7 +17,7 @@
 #include "latbuilder/Interlaced/IPDWeights.h"
 #include "netbuilder/Types.h"
 
-#include "latticetester/CoordinateSets.h"
+#include <vector>
 
 namespace LatBuilder { namespace Interlaced
 {
@@ -33,19 +33,49 @@ m_baseWeights(std::move(weights))
     fakeWeights.getProductWeights().setDefaultWeight(1);
     kernel.correctPODWeights(fakeWeights);
     typename KERNEL::CorrectionProductWeights correctionProductWeights(kernel); 
-    Dimension dim(m_baseWeights->getSize());
-    if (dim > 0){
-        LatticeTester::CoordinateSets::FromRanges projections(0, dim * kernel.interlacingFactor(), 0, dim * kernel.interlacingFactor() - 1);
-        for (auto cit = projections.begin (); cit != projections.end (); ++cit) {
-            const LatticeTester::Coordinates& projection = *cit;
-            LatticeTester::Coordinates realProjection;
-            for(Dimension coord : projection)
+    // Only the projections whose real projection has a positive weight have a nonzero interlaced weight, so they are enumerated 
+    // from the weighted real projections instead of among all the projections in dimension dim * interlacingFactor:
+    // each coordinate j of a real projection is replaced by a nonempty subset of {j * interlacingFactor, ..., (j+1) * interlacingFactor - 1}.
+    const unsigned int factor = kernel.interlacingFactor();
+    const unsigned long fullMask = (1UL << factor) - 1;
+    for(size_t coord = 0; coord < m_baseWeights->getSize(); ++coord)
+    {
+        for(const auto& projWeight : m_baseWeights->getWeightsForLargestIndex(coord))
+        {
+            const LatticeTester::Coordinates& realProjection = projWeight.first;
+            double baseWeight = m_baseWeights->getWeight(realProjection);
+            if (baseWeight <= 0)
             {
-                realProjection.insert( coord / kernel.interlacingFactor() );
+                continue;
             }
-            double baseWeight = m_baseWeights->getWeight(realProjection);
-            if (baseWeight > 0){
+            std::vector<Dimension> realCoords(realProjection.begin(), realProjection.end());
+            std::vector<unsigned long> masks(realCoords.size(), 1); // subset of the interlaced coordinates of each real coordinate
+            while (true)
+            {
+                LatticeTester::Coordinates projection;
+                for(size_t k = 0; k < realCoords.size(); ++k)
+                {
+                    for(unsigned int b = 0; b < factor; ++b)
+                    {
+                        if ((masks[k] >> b) & 1)
+                        {
+                            projection.insert(realCoords[k] * factor + b);
+                        }
+                    }
+                }
                 LatticeTester::ProjectionDependentWeights::setWeight(projection, baseWeight * fakeWeights.getWeight(realProjection) * correctionProductWeights.getWeight(projection));
+
+                size_t k = 0; // next combination of subsets
+                while (k < masks.size() && masks[k] == fullMask)
+                {
+                    masks[k] = 1;
+                    ++k;
+                }
+                if (k == masks.size())
+                {
+                    break;
+                }
+                ++masks[k];
             }
         }
     }
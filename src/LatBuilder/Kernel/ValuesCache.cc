@@ -0,0 +1,189 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "latbuilder/Kernel/ValuesCache.h"
+
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LATBUILDER_KERNEL_CACHE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace LatBuilder { namespace Kernel {
+
+namespace {
+   // file layout: magic, sizeof(Real), key length, key (padded to 8 bytes), number of values, values
+   const char Magic[8] = {'L', 'N', 'B', 'K', 'V', '0', '0', '1'};
+
+   uint64_t padded(uint64_t n)
+   { return (n + 7) / 8 * 8; }
+
+   // 64-bit FNV-1a hash, stable across platforms and runs
+   uint64_t hashKey(const std::string& key)
+   {
+      uint64_t h = 14695981039346656037ULL;
+      for (unsigned char c : key) {
+         h ^= c;
+         h *= 1099511628211ULL;
+      }
+      return h;
+   }
+
+   boost::filesystem::path cachePath(const std::string& dir, const std::string& key)
+   {
+      std::ostringstream os;
+      os << "kernel-" << std::hex << std::setw(16) << std::setfill('0') << hashKey(key) << ".dat";
+      return boost::filesystem::path(dir) / os.str();
+   }
+
+   // checks the header in the first size bytes of data and returns the
+   // offset of the values, or 0 if the header does not match
+   uint64_t checkHeader(const char* data, uint64_t size, const std::string& key, uint64_t numValues)
+   {
+      const uint64_t keyOffset = sizeof(Magic) + 2 * sizeof(uint64_t);
+      if (size < keyOffset || std::memcmp(data, Magic, sizeof(Magic)) != 0)
+         return 0;
+      uint64_t realSize, keyLength;
+      std::memcpy(&realSize, data + sizeof(Magic), sizeof(uint64_t));
+      std::memcpy(&keyLength, data + sizeof(Magic) + sizeof(uint64_t), sizeof(uint64_t));
+      if (realSize != sizeof(Real) || keyLength != key.size())
+         return 0;
+      const uint64_t countOffset = keyOffset + padded(keyLength);
+      const uint64_t valuesOffset = countOffset + sizeof(uint64_t);
+      if (size != valuesOffset + numValues * sizeof(Real))
+         return 0;
+      if (key.compare(0, key.size(), data + keyOffset, keyLength) != 0)
+         return 0;
+      uint64_t count;
+      std::memcpy(&count, data + countOffset, sizeof(uint64_t));
+      return count == numValues ? valuesOffset : 0;
+   }
+}
+
+std::string& ValuesCache::directoryRef()
+{
+   static std::string dir = [] {
+      const char* env = std::getenv("LATNETBUILDER_KERNEL_CACHE");
+      return std::string(env ? env : "");
+   }();
+   return dir;
+}
+
+void ValuesCache::setDirectory(std::string dir)
+{ directoryRef() = std::move(dir); }
+
+const std::string& ValuesCache::directory()
+{ return directoryRef(); }
+
+bool ValuesCache::load(const std::string& key, size_t size, RealVector& values)
+{
+   const auto path = cachePath(directory(), key);
+
+#ifdef LATBUILDER_KERNEL_CACHE_MMAP
+   const int fd = ::open(path.c_str(), O_RDONLY);
+   if (fd < 0)
+      return false;
+   struct stat st;
+   if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+      ::close(fd);
+      return false;
+   }
+   const uint64_t fileSize = static_cast<uint64_t>(st.st_size);
+   void* map = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+   ::close(fd);
+   if (map == MAP_FAILED)
+      return false;
+   const char* data = static_cast<const char*>(map);
+   const uint64_t offset = checkHeader(data, fileSize, key, size);
+   if (offset)
+   {
+      values.resize(size, false);
+      if (size)
+         std::memcpy(&values[0], data + offset, size * sizeof(Real));
+   }
+   ::munmap(map, fileSize);
+   return offset != 0;
+#else
+   std::ifstream is(path.string(), std::ios::binary | std::ios::ate);
+   if (!is)
+      return false;
+   const uint64_t fileSize = static_cast<uint64_t>(is.tellg());
+   std::string data(fileSize, '\0');
+   is.seekg(0);
+   if (!is.read(&data[0], fileSize))
+      return false;
+   const uint64_t offset = checkHeader(data.data(), fileSize, key, size);
+   if (offset)
+   {
+      values.resize(size, false);
+      if (size)
+         std::memcpy(&values[0], data.data() + offset, size * sizeof(Real));
+   }
+   return offset != 0;
+#endif
+}
+
+void ValuesCache::save(const std::string& key, const RealVector& values)
+{
+   boost::system::error_code ec;
+   boost::filesystem::create_directories(directory(), ec);
+
+   const auto path = cachePath(directory(), key);
+   // write to a temporary file first so that concurrent runs never see a partial file
+   auto tmpPath = path;
+   tmpPath += boost::filesystem::unique_path(".%%%%-%%%%-%%%%.tmp", ec);
+   if (ec)
+      return;
+
+   {
+      std::ofstream os(tmpPath.string(), std::ios::binary | std::ios::trunc);
+      if (!os)
+         return;
+      const uint64_t realSize = sizeof(Real);
+      const uint64_t keyLength = key.size();
+      const uint64_t count = values.size();
+      const std::string padding(padded(keyLength) - keyLength, '\0');
+      os.write(Magic, sizeof(Magic));
+      os.write(reinterpret_cast<const char*>(&realSize), sizeof(uint64_t));
+      os.write(reinterpret_cast<const char*>(&keyLength), sizeof(uint64_t));
+      os.write(key.data(), keyLength);
+      os.write(padding.data(), padding.size());
+      os.write(reinterpret_cast<const char*>(&count), sizeof(uint64_t));
+      if (count)
+         os.write(reinterpret_cast<const char*>(&values[0]), count * sizeof(Real));
+      if (!os) {
+         os.close();
+         boost::filesystem::remove(tmpPath, ec);
+         return;
+      }
+   }
+
+   boost::filesystem::rename(tmpPath, path, ec);
+   if (ec)
+      boost::filesystem::remove(tmpPath, ec);
+}
+
+}}
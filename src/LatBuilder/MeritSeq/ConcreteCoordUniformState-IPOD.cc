@@ -16,6 +16,7 @@
 
 #include "latbuilder/MeritSeq/ConcreteCoordUniformState-IPOD.h"
 #include "latbuilder/TextStream.h"
+#include <algorithm>
 #include <iostream>
 
 namespace LatBuilder { namespace MeritSeq {
@@ -51,7 +52,7 @@ reset()\
    m_state.clear();\
    m_partialWeightedState.clear(); \
    m_elemPolySum.clear();\
-   m_state.push_back(RealVector(this->storage().size(), 1.0));\
+   m_state.push_back(StateVector(this->storage().size(), 1.0));\
    m_partialWeightedState = RealVector(this->storage().size(), m_weights.getWeightForOrder(1));\
    m_elemPolySum = RealVector(this->storage().size(), 1.); /*the first elementary symmetric polynomial equals 1*/\
 }\
@@ -65,40 +66,41 @@ update(const RealVector& kernelValues, typename LatticeTraits<LR>::GenValue gen)
    CoordUniformState<LR, ET, COMPRESS, PLO>::update(kernelValues, gen);\
    const auto newCoordinate = this->dimension() - 1;\
 \
-   auto stridedKernelValues = this->storage().strided(kernelValues, gen);\
+   const RealVector& stridedKernelValues = this->stridedKernelValues(kernelValues, gen);\
+   const long size = static_cast<long>(this->storage().size());\
+   const Real* omega = &stridedKernelValues[0];\
+   Real* elemPolySum = &m_elemPolySum[0];\
    Real dweight = m_weights.getCorrectionProductWeightForCoordinate(newCoordinate);\
-   m_elemPolySum = boost::numeric::ublas::element_prod(\
-      m_elemPolySum,\
-      RealVector(this->storage().size(), 1.) + dweight * stridedKernelValues\
-      );\
    if (newCoordinate % m_interlacingFactor == m_interlacingFactor-1){\
       /*we are changing of `real` coordinate*/\
-      m_elemPolySum -= RealVector(this->storage().size(), 1.);\
+      /*the constant term of the product is removed in the same pass*/\
+      _Pragma("omp parallel for if(size >= static_cast<long>(MinParallelSize))")\
+      for (long i = 0; i < size; i++)\
+         elemPolySum[i] = elemPolySum[i] * (1.0 + dweight * omega[i]) - 1.0;\
 \
       const Real pweight = m_weights.getWeightForCoordinate(newCoordinate / m_interlacingFactor);\
 \
-      \
-      m_state.push_back(RealVector(this->storage().size(), 0.0));\
+      this->updateOrders(m_state, elemPolySum, pweight);\
 \
-      for (size_t order = m_state.size() - 1; order > 0; order--)\
-            m_state[order] += boost::numeric::ublas::element_prod(\
-                  pweight * m_elemPolySum,\
-                  m_state[order - 1]\
-                  );\
-\
-      m_partialWeightedState = RealVector(this->storage().size(), 0.);\
-      for (size_t order = 0; order < m_state.size(); order++){\
-            m_partialWeightedState += m_weights.getWeightForOrder(order+1) * m_state[order];\
-      }\
-      m_elemPolySum = RealVector(this->storage().size(), 1.);\
+      std::vector<std::pair<Real, const StateReal*>> terms;\
+      terms.reserve(m_state.size());\
+      for (size_t order = 0; order < m_state.size(); order++)\
+         terms.emplace_back(m_weights.getWeightForOrder(order+1), &m_state[order][0]);\
+      this->weightedSum(terms, this->storage().size(), m_partialWeightedState, false);\
 \
+      std::fill(m_elemPolySum.begin(), m_elemPolySum.end(), 1.0);\
+   }\
+   else {\
+      _Pragma("omp parallel for if(size >= static_cast<long>(MinParallelSize))")\
+      for (long i = 0; i < size; i++)\
+         elemPolySum[i] *= 1.0 + dweight * omega[i];\
    }\
 }\
 \
 template <LatticeType LR, EmbeddingType ET, Compress COMPRESS, PerLevelOrder PLO>\
-RealVector \
+void \
 ConcreteCoordUniformState<LR, ET, COMPRESS, PLO, LatBuilder::Interlaced::IPODWeights<KERNEL>>::\
-weightedState() const\
+weightedState(RealVector& out, bool accumulate) const\
 {\
    using LatticeTester::Coordinates;\
 \
@@ -106,11 +108,24 @@ weightedState() const\
 \
    const Real pweight = m_weights.getWeightForCoordinate(nextCoordinate / m_interlacingFactor);\
    const Real dweight = m_weights.getCorrectionProductWeightForCoordinate(nextCoordinate);\
-\
-   return boost::numeric::ublas::element_prod(\
-         pweight * dweight * m_elemPolySum,\
-         m_partialWeightedState\
-   );\
+   const Real weight = pweight * dweight;\
+\
+   const long size = static_cast<long>(this->storage().size());\
+   if (!accumulate && out.size() != this->storage().size())\
+      out.resize(size, false);\
+   Real* res = &out[0];\
+   const Real* elemPolySum = &m_elemPolySum[0];\
+   const Real* partial = &m_partialWeightedState[0];\
+   if (accumulate) {\
+      _Pragma("omp parallel for if(size >= static_cast<long>(MinParallelSize))")\
+      for (long i = 0; i < size; i++)\
+         res[i] += weight * elemPolySum[i] * partial[i];\
+   }\
+   else {\
+      _Pragma("omp parallel for if(size >= static_cast<long>(MinParallelSize))")\
+      for (long i = 0; i < size; i++)\
+         res[i] = weight * elemPolySum[i] * partial[i];\
+   }\
 }\
 \
 /*Ordinary state must be instantiated for compatibility purposes but will throw a runtime error when constructed.*/\
@@ -30,7 +30,9 @@ reset()
    CoordUniformState<LR, ET, COMPRESS, PLO>::reset();
    m_state.clear();
    // order 0
-   m_state.push_back(RealVector(this->storage().size(), 1.0));
+   m_state.push_back(StateVector(this->storage().size(), 1.0));
+   // orders with zero weights beyond the last nonzero one are never stored
+   m_maxOrders = numContributingOrders(m_weights);
 }
 
 //===========================================================================
@@ -42,30 +44,23 @@ update(const RealVector& kernelValues, typename LatticeTraits<LR>::GenValue gen)
 {
    CoordUniformState<LR, ET, COMPRESS, PLO>::update(kernelValues, gen);
 
-   auto stridedKernelValues = this->storage().strided(kernelValues, gen);
+   const RealVector& stridedKernelValues = this->stridedKernelValues(kernelValues, gen);
 
-   // add new order
-   m_state.push_back(RealVector(this->storage().size(), 0.0));
-
-   // recursive update by decreasing order to avoid unwanted overwriting
-   for (size_t order = m_state.size() - 1; order > 0; order--)
-      m_state[order] += boost::numeric::ublas::element_prod(
-            stridedKernelValues,
-            m_state[order - 1]
-            );
+   // add new order and update all orders in one pass
+   this->updateOrders(m_state, &stridedKernelValues[0], 1.0, m_maxOrders);
 }
 
 //===========================================================================
 
 template <LatticeType LR, EmbeddingType ET, Compress COMPRESS, PerLevelOrder PLO>
-RealVector
+void
 ConcreteCoordUniformState<LR, ET, COMPRESS, PLO, LatticeTester::OrderDependentWeights>::
-weightedState() const
+weightedState(RealVector& out, bool accumulate) const
 {
    using LatticeTester::Coordinates;
 
-   RealVector weightedState =
-      boost::numeric::ublas::scalar_vector<Real>(this->storage().size(), 0.0);
+   std::vector<std::pair<Real, const StateReal*>> terms;
+   terms.reserve(m_state.size());
 
    for (Coordinates::size_type order = 0; order < m_state.size(); order++) {
 
@@ -74,10 +69,10 @@ weightedState() const
       if (weight == 0.0)
          continue;
 
-      weightedState += weight * m_state[order];
+      terms.emplace_back(weight, &m_state[order][0]);
    }
 
-   return weightedState;
+   this->weightedSum(terms, this->storage().size(), out, accumulate);
 }
 
 template class ConcreteCoordUniformState<LatticeType::ORDINARY, EmbeddingType::UNILEVEL, Compress::NONE, PerLevelOrder::BASIC,      LatticeTester::OrderDependentWeights>;
@@ -41,32 +41,37 @@ update(const RealVector& kernelValues, typename LatticeTraits<LR>::GenValue gen)
 {
    CoordUniformState<LR, ET, COMPRESS, PLO>::update(kernelValues, gen);
 
-   auto stridedKernelValues = this->storage().strided(kernelValues, gen);
+   const RealVector& stridedKernelValues = this->stridedKernelValues(kernelValues, gen);
 
    const auto newCoordinate = this->dimension() - 1;
 
    const Real weight = m_weights.getWeightForCoordinate(newCoordinate);
 
-   const auto ones = boost::numeric::ublas::scalar_vector<Real>(this->storage().size(), 1.0);
+   const long size = static_cast<long>(this->storage().size());
+   const Real* omega = &stridedKernelValues[0];
+   Real* state = &m_state[0];
 
-   m_state = boost::numeric::ublas::element_prod(
-         ones + weight * stridedKernelValues,
-         m_state
-         );
+   #pragma omp parallel for if(size >= static_cast<long>(MinParallelSize))
+   for (long i = 0; i < size; i++)
+      state[i] *= 1.0 + weight * omega[i];
 }
 
 //===========================================================================
 
 template <LatticeType LR, EmbeddingType ET, Compress COMPRESS, PerLevelOrder PLO>
-RealVector
+void
 ConcreteCoordUniformState<LR, ET, COMPRESS, PLO, LatticeTester::ProductWeights>::
-weightedState() const
+weightedState(RealVector& out, bool accumulate) const
 {
    const auto nextCoordinate = this->dimension();
 
    const Real weight = m_weights.getWeightForCoordinate(nextCoordinate);
 
-   return weight * m_state;
+   std::vector<std::pair<Real, const Real*>> terms;
+   if (weight != 0.0)
+      terms.emplace_back(weight, &m_state[0]);
+
+   this->weightedSum(terms, this->storage().size(), out, accumulate);
 }
 
 template class ConcreteCoordUniformState<LatticeType::ORDINARY, EmbeddingType::UNILEVEL, Compress::NONE, PerLevelOrder::BASIC,      LatticeTester::ProductWeights>;
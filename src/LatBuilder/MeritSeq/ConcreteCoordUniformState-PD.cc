@@ -30,15 +30,14 @@ reset()
    CoordUniformState<LR, ET, COMPRESS, PLO>::reset();
    m_state.clear();
    // empty set
-   m_state[LatticeTester::Coordinates()] =
-      boost::numeric::ublas::scalar_vector<Real>(this->storage().size(), 1.0);
+   m_state[LatticeTester::Coordinates()] = StateVector(this->storage().size(), 1.0);
    m_gen.clear();
 }
 
 //===========================================================================
 
 template <LatticeType LR, EmbeddingType ET, Compress COMPRESS, PerLevelOrder PLO>
-const RealVector&
+const StateVector&
 ConcreteCoordUniformState<LR, ET, COMPRESS, PLO, LatticeTester::ProjectionDependentWeights>::
 createStateVector(const LatticeTester::Coordinates& projection, const RealVector& kernelValues)
 {
@@ -53,17 +52,22 @@ createStateVector(const LatticeTester::Coordinates& projection, const RealVector
    LatticeTester::Coordinates baseProjection = projection;
    baseProjection.erase(largestCoord);
    // create base state vector
-   const RealVector& baseState = createStateVector(baseProjection, kernelValues);
+   const StateVector& baseState = createStateVector(baseProjection, kernelValues);
 
    // compute merit value for new projection
-   auto stridedKernelValues = this->storage().strided(
-         kernelValues,
-         m_gen[largestCoord]
-         );
-   return m_state[projection] = boost::numeric::ublas::element_prod(
-         stridedKernelValues,
-         baseState
-         );
+   const RealVector& stridedKernelValues = this->stridedKernelValues(kernelValues, m_gen[largestCoord]);
+
+   const long size = static_cast<long>(this->storage().size());
+   StateVector newState(size);
+   StateReal* state = &newState[0];
+   const Real* omega = &stridedKernelValues[0];
+   const StateReal* base = &baseState[0];
+
+   #pragma omp parallel for if(size >= static_cast<long>(MinParallelSize))
+   for (long i = 0; i < size; i++)
+      state[i] = static_cast<StateReal>(omega[i] * base[i]);
+
+   return m_state[projection] = std::move(newState);
 }
 
 //===========================================================================
@@ -92,16 +96,15 @@ update(const RealVector& kernelValues, typename LatticeTraits<LR>::GenValue gen)
 //===========================================================================
 
 template <LatticeType LR, EmbeddingType ET, Compress COMPRESS, PerLevelOrder PLO>
-RealVector
+void
 ConcreteCoordUniformState<LR, ET, COMPRESS, PLO, LatticeTester::ProjectionDependentWeights>::
-weightedState() const
+weightedState(RealVector& out, bool accumulate) const
 {
    using LatticeTester::Coordinates;
 
    const auto nextCoordinate = this->dimension();
 
-   RealVector weightedState =
-      boost::numeric::ublas::scalar_vector<Real>(this->storage().size(), 0.0);
+   std::vector<std::pair<Real, const StateReal*>> terms;
 
    for (const auto& pw : m_weights.getWeightsForLargestIndex(nextCoordinate)) {
       // remove largest coordinate index
@@ -112,10 +115,10 @@ weightedState() const
       if (it == m_state.end())
          throw std::runtime_error("projection-dependent state was not created");
       // contribute to weighted state
-      weightedState += pw.second * it->second;
+      terms.emplace_back(pw.second, &it->second[0]);
    }
 
-   return weightedState;
+   this->weightedSum(terms, this->storage().size(), out, accumulate);
 }
 
 //===========================================================================
@@ -0,0 +1,122 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "latbuilder/OutOfCore.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LATBUILDER_OUT_OF_CORE_MMAP
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace LatBuilder {
+
+namespace {
+   struct Registry {
+      std::mutex mutex;
+      std::unordered_map<void*, size_t> mappings;
+      // lets deallocate() skip the lock when nothing is mapped
+      std::atomic<size_t> count{0};
+   };
+
+   Registry& registry()
+   {
+      static Registry r;
+      return r;
+   }
+
+   std::string& directoryRef()
+   {
+      static std::string dir = [] {
+         const char* env = std::getenv("LATNETBUILDER_OUT_OF_CORE");
+         return std::string(env ? env : "");
+      }();
+      return dir;
+   }
+}
+
+void OutOfCore::setDirectory(std::string dir)
+{ directoryRef() = std::move(dir); }
+
+const std::string& OutOfCore::directory()
+{ return directoryRef(); }
+
+void* OutOfCore::allocate(size_t bytes)
+{
+#ifdef LATBUILDER_OUT_OF_CORE_MMAP
+   const std::string& dir = directory();
+   if (dir.empty() or bytes == 0)
+      return nullptr;
+
+   std::string pattern = dir + "/latnetbuilder-XXXXXX";
+   std::vector<char> path(pattern.begin(), pattern.end());
+   path.push_back('\0');
+   const int fd = ::mkstemp(path.data());
+   if (fd < 0)
+      return nullptr;
+   // the file disappears with the last mapping, even if the process aborts
+   ::unlink(path.data());
+   if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+      ::close(fd);
+      return nullptr;
+   }
+   void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   ::close(fd);
+   if (p == MAP_FAILED)
+      return nullptr;
+
+   Registry& r = registry();
+   std::lock_guard<std::mutex> lock(r.mutex);
+   r.mappings.emplace(p, bytes);
+   ++r.count;
+   return p;
+#else
+   (void)bytes;
+   return nullptr;
+#endif
+}
+
+bool OutOfCore::deallocate(void* p, size_t bytes)
+{
+#ifdef LATBUILDER_OUT_OF_CORE_MMAP
+   Registry& r = registry();
+   if (r.count == 0)
+      return false;
+   {
+      std::lock_guard<std::mutex> lock(r.mutex);
+      auto it = r.mappings.find(p);
+      if (it == r.mappings.end())
+         return false;
+      bytes = it->second;
+      r.mappings.erase(it);
+      --r.count;
+   }
+   ::munmap(p, bytes);
+   return true;
+#else
+   (void)p;
+   (void)bytes;
+   return false;
+#endif
+}
+
+}
@@ -0,0 +1,191 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "latbuilder/ProjDepMerit/Spectral.h"
+#include "latbuilder/Util.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace LatBuilder { namespace ProjDepMerit { namespace detail {
+
+namespace {
+#ifdef __SIZEOF_INT128__
+   typedef __int128 Wide;
+#else
+   typedef long double Wide;
+#endif
+
+   typedef std::array<std::int64_t, 3> Vec;
+
+   Wide dot(const Vec& x, const Vec& y)
+   { return Wide(x[0]) * y[0] + Wide(x[1]) * y[1] + Wide(x[2]) * y[2]; }
+
+   // subtracts mu * u from v
+   void sub(Vec& v, std::int64_t mu, const Vec& u)
+   {
+      for (size_t i = 0; i < v.size(); i++)
+         v[i] -= mu * u[i];
+   }
+
+   // nearest integer to num / den, for den > 0
+   std::int64_t roundDiv(Wide num, Wide den)
+   {
+#ifdef __SIZEOF_INT128__
+      const Wide twice = 2 * num + den;
+      Wide q = twice / (2 * den);
+      if (twice % (2 * den) < 0)
+         --q;
+      return static_cast<std::int64_t>(q);
+#else
+      return static_cast<std::int64_t>(std::floor(num / den + 0.5L));
+#endif
+   }
+
+   // Lagrange-Gauss reduction: on return, u is a shortest vector of L(u, v)
+   // and the basis (u, v) is reduced
+   void gauss(Vec& u, Vec& v)
+   {
+      Wide nu = dot(u, u);
+      Wide nv = dot(v, v);
+      if (nv < nu) {
+         std::swap(u, v);
+         std::swap(nu, nv);
+      }
+      while (true) {
+         sub(v, roundDiv(dot(u, v), nu), u);
+         nv = dot(v, v);
+         if (nv >= nu)
+            return;
+         std::swap(u, v);
+         std::swap(nu, nv);
+      }
+   }
+
+   // greedy reduction of Nguyen and Stehle (2004), which yields a
+   // Minkowski-reduced basis in dimension 3: on return, b[0] is a shortest
+   // vector of the lattice
+   void greedy(std::array<Vec, 3>& b)
+   {
+      while (true) {
+         std::sort(b.begin(), b.end(), [] (const Vec& x, const Vec& y) { return dot(x, x) < dot(y, y); });
+         gauss(b[0], b[1]);
+
+         // closest vector to b[2] in L(b[0], b[1]), searched around the
+         // real coordinates of the orthogonal projection of b[2]
+         const Wide g00 = dot(b[0], b[0]);
+         const Wide g01 = dot(b[0], b[1]);
+         const Wide g11 = dot(b[1], b[1]);
+         const Wide t0 = dot(b[2], b[0]);
+         const Wide t1 = dot(b[2], b[1]);
+         const long double det = static_cast<long double>(g00 * g11 - g01 * g01);
+         const long double x0 = static_cast<long double>(t0 * g11 - t1 * g01) / det;
+         const long double x1 = static_cast<long double>(t1 * g00 - t0 * g01) / det;
+
+         Vec best = b[2];
+         Wide bestNorm = dot(best, best);
+         const std::int64_t c0 = static_cast<std::int64_t>(std::floor(x0));
+         const std::int64_t c1 = static_cast<std::int64_t>(std::floor(x1));
+         for (std::int64_t i = c0 - 1; i <= c0 + 2; i++) {
+            for (std::int64_t j = c1 - 1; j <= c1 + 2; j++) {
+               Vec v = b[2];
+               sub(v, i, b[0]);
+               sub(v, j, b[1]);
+               const Wide norm = dot(v, v);
+               if (norm < bestNorm) {
+                  best = v;
+                  bestNorm = norm;
+               }
+            }
+         }
+         b[2] = best;
+         if (bestNorm >= g11)
+            return;
+      }
+   }
+
+   // inverse of a modulo n, or 0 if a is not invertible
+   uInteger inverse(uInteger a, uInteger n)
+   {
+      if (n == 1)
+         return 0;
+      const auto uv = egcd(a, n);
+      const long long x = uv.first % static_cast<long long>(n);
+      const uInteger inv = static_cast<uInteger>(x < 0 ? x + static_cast<long long>(n) : x);
+      return mulMod(a, inv, n) == 1 ? inv : 0;
+   }
+}
+
+Real lowOrderShortestDualVector(uInteger numPoints, const std::int64_t* gen, size_t order)
+{
+   if (order == 0 or order > 3 or numPoints < 2 or numPoints >> 62)
+      return 0.0;
+
+   const uInteger n = numPoints;
+   std::array<uInteger, 3> a;
+   for (size_t j = 0; j < order; j++) {
+      const std::int64_t g = gen[j] % static_cast<std::int64_t>(n);
+      a[j] = static_cast<uInteger>(g < 0 ? g + static_cast<std::int64_t>(n) : g);
+   }
+
+   if (order == 1) {
+      // the dual lattice is generated by n / gcd(a, n)
+      uInteger g = n, r = a[0];
+      while (r) {
+         const uInteger t = g % r;
+         g = r;
+         r = t;
+      }
+      return static_cast<Real>(n / g) * static_cast<Real>(n / g);
+   }
+
+   // coordinate k with an invertible component
+   size_t k = 0;
+   uInteger inv = 0;
+   for (; k < order; k++) {
+      if ((inv = inverse(a[k], n)) != 0)
+         break;
+   }
+   if (k == order)
+      return 0.0;
+
+   // basis of the dual lattice: n e_k, and e_j + c_j e_k for j != k,
+   // with c_j = -a_j / a_k mod n
+   std::array<Vec, 3> b;
+   size_t m = 0;
+   for (size_t j = 0; j < order; j++) {
+      if (j == k)
+         continue;
+      Vec v = {{0, 0, 0}};
+      uInteger c = mulMod(a[j], inv, n);
+      c = c == 0 ? 0 : n - c;
+      v[j] = 1;
+      v[k] = c > n / 2 ? static_cast<std::int64_t>(c) - static_cast<std::int64_t>(n) : static_cast<std::int64_t>(c);
+      b[m++] = v;
+   }
+   b[m] = Vec{{0, 0, 0}};
+   b[m][k] = static_cast<std::int64_t>(n);
+
+   if (order == 2) {
+      gauss(b[0], b[1]);
+      return static_cast<Real>(dot(b[0], b[0]));
+   }
+   greedy(b);
+   return static_cast<Real>(dot(b[0], b[0]));
+}
+
+}}}
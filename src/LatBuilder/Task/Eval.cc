@@ -19,5 +19,6 @@
 namespace LatBuilder { namespace Task {
 
 TASK_FOR_ALL(TASK_BIND_TEMPLATE, CBCBasedSearch, Eval);
+TASK_FOR_ALL(TASK_BIND_TEMPLATE1, Eval, NOTAG);
 
 }}
@@ -19,6 +19,10 @@
 #include "latbuilder/Parser/CommandLine.h"   
 #include "latbuilder/TextStream.h"
 #include "latbuilder/Types.h"
+#include "latbuilder/Kernel/ValuesCache.h"
+#include "latbuilder/OutOfCore.h"
+#include "latbuilder/Parallel.h"
+#include "latbuilder/fftw++.h"
 
 #include "netbuilder/DigitalNet.h"
 #include "netbuilder/Types.h"
@@ -165,7 +169,15 @@ makeOptionsDescription()
     ("output-style,O", po::value<std::string>()->default_value(""),
     "(optional) TBD")
    ("merit-digits-displayed", po::value<unsigned int>()->default_value(0),
-    "(optional) number of significant figures to use when displaying merit values\n");
+    "(optional) number of significant figures to use when displaying merit values\n")
+   ("kernel-cache", po::value<std::string>(),
+    "(optional) path to a folder where the kernel values are saved and reused by later runs with the same kernel and size parameter (default: value of the LATNETBUILDER_KERNEL_CACHE environment variable, if set)\n")
+   ("out-of-core", po::value<std::string>(),
+    "(optional) path to a folder where the large vectors of kernel values and states are stored in memory-mapped files, to search lattices whose vectors do not fit in memory (default: value of the LATNETBUILDER_OUT_OF_CORE environment variable, if set)\n")
+   ("parallel-projections", po::value<std::string>()->default_value("false"),
+    "(optional) evaluate the projections of a projection-dependent figure of merit in parallel (useful for expensive figures such as spectral ones); possible values:\n"
+   "  false (default)\n"
+   "  true\n");
 
    return desc;
 }
@@ -406,6 +418,10 @@ void executePolynomial(const Parser::CommandLine<LatticeType::POLYNOMIAL, ET>& c
 
 int main(int argc, const char *argv[])
 {
+#ifdef FFTWXX_USE_THREADS
+   // must precede any other call to FFTW
+   fftw<Real>::init_threads();
+#endif
 
    try {
         auto opt = parse(argc, argv);
@@ -425,6 +441,14 @@ int main(int argc, const char *argv[])
         // global variable
         merit_digits_displayed = opt["merit-digits-displayed"].as<unsigned int>();
 
+        if (opt.count("kernel-cache") >= 1)
+          Kernel::ValuesCache::setDirectory(opt["kernel-cache"].as<std::string>());
+
+        if (opt.count("out-of-core") >= 1)
+          OutOfCore::setDirectory(opt["out-of-core"].as<std::string>());
+
+        setParallelProjections(opt["parallel-projections"].as<std::string>() == "true");
+
         std::string outputstyle = opt["output-style"].as<std::string>();
 
        LatBuilder::LatticeType lattice = Parser::LatticeParser::parse(opt["construction"].as<std::string>());
@@ -17,6 +17,7 @@
 #include <map>
 #include <fstream>
 #include <algorithm>
+#include <vector>
 
 #include "netbuilder/FigureOfMerit/TValueComputation.h"
 #include "netbuilder/Helpers/RankComputer.h"
@@ -26,22 +27,36 @@
 
 namespace NetBuilder {
 
-unsigned int iteration_on_k(std::vector<GeneratingMatrix>& baseMatrices, unsigned int k, int verbose){
+/**
+ * Computes the smallest number of columns for which all the matrices made of the first rows of the base matrices
+ * (the numbers of rows given by a composition of \c k) are of full rank.
+ * @param baseMatrices Base matrices.
+ * @param k Total number of rows.
+ * @param rankComputer Rank computer, reset by the function, so that its memory is reused from one call to the other.
+ * @param rowIndices Flat table which maps row \c r of the <tt>j</tt>-th part of the composition to a row of the
+ * rank computer, at index <CODE> (j-1) * (k-s+1) + r-1 </CODE>. Only used as storage, resized by the function.
+ * @param verbose Verbosity level.
+ */
+unsigned int iteration_on_k(const GeneratingMatricesView& baseMatrices, unsigned int k, RankComputer& rankComputer, std::vector<unsigned int>& rowIndices, int verbose){
     unsigned int nCols = baseMatrices[0].nCols();
     unsigned int s = (unsigned int) baseMatrices.size();
     
     // Initialization of row map from original matrices to computation matrix
-    std::map<std::pair<int, int>, int> Origin_to_M;
+    const unsigned int maxRowsPerPart = k-s+1;
+    rowIndices.resize(s * maxRowsPerPart);
+    auto rowIndex = [&rowIndices, maxRowsPerPart](const std::pair<int, int>& partRow) -> unsigned int& { 
+        return rowIndices[(partRow.first-1) * maxRowsPerPart + partRow.second-1]; 
+    };
 
-    RankComputer rankComputer(nCols);
+    rankComputer.reset(nCols);
 
     for (unsigned int i=0; i<k-s+1; i++){
-        Origin_to_M[{1, i+1}] = i;
-        rankComputer.addRow(baseMatrices[s-1].subMatrix(i, 0, 1, nCols));
+        rowIndex({1, i+1}) = i;
+        rankComputer.addRow(baseMatrices[s-1][i]);
     }
     for (unsigned int i=1; i<s; i++){
-        Origin_to_M[{i+1, 1}] = k-s+i;
-        rankComputer.addRow(baseMatrices[s-1-i].subMatrix(0, 0, 1, nCols));
+        rowIndex({i+1, 1}) = k-s+i;
+        rankComputer.addRow(baseMatrices[s-1-i][0]);
     }
 
     unsigned int smallestFullRankIndex = rankComputer.smallestFullRank() - 1;
@@ -54,15 +69,13 @@ unsigned int iteration_on_k(std::vector<GeneratingMatrix>& baseMatrices, unsigne
 
     while (compositionMaker.goToNextComposition()) {
 
-        std::pair<std::pair<int, int>, std::pair<int, int>> rowChange = compositionMaker.changeFromPreviousComposition();
+        const std::pair<std::pair<int, int>, std::pair<int, int>>& rowChange = compositionMaker.changeFromPreviousComposition();
 
-        int ind_exchange = Origin_to_M[rowChange.first];
-        Origin_to_M[rowChange.second] = ind_exchange;
-        Origin_to_M.erase(rowChange.first);
+        // the row which leaves the composition is replaced in place by the row which enters it
+        unsigned int ind_exchange = rowIndex(rowChange.first);
+        rowIndex(rowChange.second) = ind_exchange;
         
-        GeneratingMatrix newRow = baseMatrices[s-rowChange.second.first].subMatrix(rowChange.second.second-1, 0, 1, nCols);
-
-        rankComputer.replaceRow(ind_exchange, std::move(newRow), verbose-1);
+        rankComputer.replaceRow(ind_exchange, baseMatrices[s-rowChange.second.first][rowChange.second.second-1], verbose-1);
 
         smallestFullRankIndex = rankComputer.smallestFullRank() - 1;
 
@@ -73,7 +86,7 @@ unsigned int iteration_on_k(std::vector<GeneratingMatrix>& baseMatrices, unsigne
     return smallestFullRankIndex;
 }
 
-unsigned int GaussMethod::computeTValue(std::vector<GeneratingMatrix> baseMatrices, unsigned int maxSubProj, int verbose=0)
+unsigned int GaussMethod::computeTValue(GeneratingMatricesView baseMatrices, unsigned int maxSubProj, int verbose=0)
 {
     unsigned int s = (unsigned int) baseMatrices.size();
     if (s == 1)
@@ -81,10 +94,42 @@ unsigned int GaussMethod::computeTValue(std::vector<GeneratingMatrix> baseMatric
         return 0;
     }
 
-    return GaussMethod::computeTValue(baseMatrices, baseMatrices[0].nCols()-1, {maxSubProj}, verbose)[0];
+    return GaussMethod::computeTValue(baseMatrices, baseMatrices[0].nCols()-1, std::vector<unsigned int>{maxSubProj}, verbose)[0];
 }
 
-std::vector<unsigned int> GaussMethod::computeTValue(std::vector<GeneratingMatrix> baseMatrices, unsigned int mMin, const std::vector<unsigned int>& maxSubProj, int verbose=0)
+unsigned int GaussMethod::computeTValue(GeneratingMatricesView baseMatrices, unsigned int maxSubProj, unsigned int tValueBound, int verbose)
+{
+    unsigned int nRows = baseMatrices[0].nRows();
+    unsigned int nCols = baseMatrices[0].nCols();
+    unsigned int s = (unsigned int) baseMatrices.size();
+
+    if (s == 1)
+    {
+        return 0;
+    }
+    if (maxSubProj > tValueBound)
+    {
+        return maxSubProj;
+    }
+    if (s > nCols || tValueBound >= nCols-s+1) // the t-value is at most max(nCols-s+1, maxSubProj)
+    {
+        return GaussMethod::computeTValue(baseMatrices, maxSubProj, verbose);
+    }
+
+    // The t-value is nCols-k for the largest k such that all the systems with k rows are of full rank, so it is not larger 
+    // than tValueBound if and only if this holds for some k >= nCols-tValueBound (which is larger than s-1).
+    RankComputer rankComputer(nCols);
+    std::vector<unsigned int> rowIndices;
+
+    for (unsigned int k=nRows-maxSubProj; k >= nCols-tValueBound; k--){
+        if (iteration_on_k(baseMatrices, k, rankComputer, rowIndices, verbose-1) < nCols){
+            return std::max(nCols-k, maxSubProj);
+        }
+    }
+    return tValueBound+1;
+}
+
+std::vector<unsigned int> GaussMethod::computeTValue(GeneratingMatricesView baseMatrices, unsigned int mMin, const std::vector<unsigned int>& maxSubProj, int verbose=0)
 {
     unsigned int nRows = baseMatrices[0].nRows();
     unsigned int nCols = baseMatrices[0].nCols();
@@ -95,7 +140,7 @@ std::vector<unsigned int> GaussMethod::computeTValue(std::vector<GeneratingMatri
     if (s == 1){
         RankComputer rankComputer(nCols);
         for (unsigned int r=0; r<nRows; r++){
-            rankComputer.addRow(baseMatrices[0].subMatrix(r, 0, 1, nCols));
+            rankComputer.addRow(baseMatrices[0][r]);
         }
         std::map<unsigned int, unsigned int> pivotPos = rankComputer.getPivots();
         
@@ -132,9 +177,12 @@ std::vector<unsigned int> GaussMethod::computeTValue(std::vector<GeneratingMatri
     }
     unsigned int previousIndSmallestInvertible = nLevel;
     
+    // shared by all the values of k
+    RankComputer rankComputer(nCols);
+    std::vector<unsigned int> rowIndices;
 
     for (unsigned int k=nRows-maxSubProj.back(); k >= s; k--){
-        unsigned int smallestFullRankIndex = iteration_on_k(baseMatrices, k, verbose-1);
+        unsigned int smallestFullRankIndex = iteration_on_k(baseMatrices, k, rankComputer, rowIndices, verbose-1);
         if (smallestFullRankIndex == nCols){
             continue;
         }
@@ -75,7 +75,7 @@ GeneratingMatrix GeneratingMatrix::fromColsReverse(unsigned int nInputBits, unsi
     
 }
 
-GeneratingMatrix::Row GeneratingMatrix::operator[](unsigned int i) const
+const GeneratingMatrix::Row& GeneratingMatrix::operator[](unsigned int i) const
 {
     return m_data[i];
 }
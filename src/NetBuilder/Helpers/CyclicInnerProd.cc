@@ -0,0 +1,191 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "netbuilder/Helpers/CyclicInnerProd.h"
+#include "netbuilder/NetConstructionTraits.h"
+
+#include "latbuilder/Parallel.h"
+#include "latbuilder/Util.h"
+
+#include <algorithm>
+#include <complex>
+#include <memory>
+
+namespace NetBuilder {
+
+    namespace {
+        // maximum number of polynomials tried as primitive elements
+        const uInteger MaxGeneratorTrials = 64;
+
+        // minimum size of the transform for it to be split across threads
+        const uInteger MinThreadedFFTSize = 1 << 16;
+
+        uInteger inverseGrayCode(uInteger g)
+        {
+            for (unsigned int shift = 1; shift < 8 * sizeof(uInteger); shift <<= 1)
+            {
+                g ^= g >> shift;
+            }
+            return g;
+        }
+    }
+
+    CyclicInnerProd::CyclicInnerProd():
+        m_valid(false),
+        m_modulus(0),
+        m_degree(0),
+        m_kernelZero(0)
+    {}
+
+    uInteger CyclicInnerProd::multiplyMod(uInteger a, uInteger b) const
+    {
+        uInteger res = 0;
+        while (b)
+        {
+            if (b & 1)
+            {
+                res ^= a;
+            }
+            b >>= 1;
+            a <<= 1;
+            if ((a >> m_degree) & 1)
+            {
+                a ^= m_modulus;
+            }
+        }
+        return res;
+    }
+
+    uInteger CyclicInnerProd::powerMod(uInteger a, uInteger exponent) const
+    {
+        uInteger res = 1;
+        while (exponent)
+        {
+            if (exponent & 1)
+            {
+                res = multiplyMod(res, a);
+            }
+            exponent >>= 1;
+            a = multiplyMod(a, a);
+        }
+        return res;
+    }
+
+    bool CyclicInnerProd::init(const Polynomial& modulus, const RealVector& kernelValues)
+    {
+        m_valid = false;
+        m_workspace.clear();
+        m_modulus = LatBuilder::IndexOfPolynomial(modulus);
+        m_degree = (unsigned int) deg(modulus);
+
+        if (m_degree < 1 || m_degree >= 8 * sizeof(uInteger) - 1 || kernelValues.size() != (uInteger(1) << m_degree))
+        {
+            return false;
+        }
+
+        const uInteger order = (uInteger(1) << m_degree) - 1;
+
+        // look for an element of order 2^m - 1, which exists if and only if the modulus is irreducible
+        const std::vector<uInteger> factors = LatBuilder::primeFactors(order);
+        uInteger generator = 0;
+        for (uInteger g = 1; g <= std::min(order, MaxGeneratorTrials); ++g)
+        {
+            if (powerMod(g, order) == 1 &&
+                std::all_of(factors.begin(), factors.end(), [&](uInteger f) { return powerMod(g, order / f) != 1; }))
+            {
+                generator = g;
+                break;
+            }
+        }
+        if (generator == 0)
+        {
+            return false;
+        }
+
+        // the columns of the generating matrix of the polynomial 1 give the kernel index of each power of z
+        std::unique_ptr<GeneratingMatrix> identity(NetConstructionTraits<NetConstruction::POLYNOMIAL>::createGeneratingMatrix(LatBuilder::PolynomialFromInt(1), modulus, 0));
+        const std::vector<unsigned long> basis = identity->getColsReverse();
+
+        // inside a parallel region (e.g., a BatchEval worker), each transform is single-threaded
+        m_workspace.emplace_back(order, order >= MinThreadedFFTSize and !LatBuilder::inParallel() ? LatBuilder::maxThreads() : 1);
+        auto& work = m_workspace.front();
+        Real* data = work.real_data();
+
+        m_kernelZero = kernelValues[0];
+        m_stateIndex.resize(order);
+        m_kernelLog.assign(order + 1, 0);
+        uInteger residue = 1;
+        for (uInteger s = 0; s < order; ++s)
+        {
+            uInteger kernelIndex = 0;
+            for (unsigned int c = 0; c < m_degree; ++c)
+            {
+                if ((residue >> c) & 1)
+                {
+                    kernelIndex ^= basis[c];
+                }
+            }
+            m_stateIndex[s] = inverseGrayCode(residue);
+            m_kernelLog[kernelIndex] = s;
+            data[s] = kernelValues[kernelIndex];
+            residue = multiplyMod(residue, generator);
+        }
+
+        work.forward();
+        m_kernelFFT.assign(work.complex_data(), work.complex_data() + work.complex_size());
+        m_products.assign(order, 0);
+        m_valid = true;
+        return true;
+    }
+
+    void CyclicInnerProd::computeProducts(const RealVector& state)
+    {
+        auto& work = m_workspace.front();
+        Real* data = work.real_data();
+        const long order = (long) m_stateIndex.size();
+
+        for (long s = 0; s < order; ++s)
+        {
+            data[s] = state[m_stateIndex[s]];
+        }
+        work.forward();
+
+        // cyclic correlation of the state with the kernel values
+        const Real scale = Real(1) / order;
+        auto cvec = work.complex_data();
+        const long csize = (long) work.complex_size();
+        #pragma omp parallel for if(work.threads() > 1)
+        for (long i = 0; i < csize; ++i)
+        {
+            cvec[i] = scale * std::conj(cvec[i]) * m_kernelFFT[i];
+        }
+        work.backward();
+
+        // the origin is mapped to itself by all the generating matrices
+        const Real origin = state[0] * m_kernelZero;
+        for (long t = 0; t < order; ++t)
+        {
+            m_products[t] = data[t] + origin;
+        }
+    }
+
+    Real CyclicInnerProd::product(const GeneratingMatrix& matrix) const
+    {
+        // the first column of the matrix gives the kernel index of q(z) itself
+        return m_products[m_kernelLog[matrix.getColsReverse()[0]]];
+    }
+
+}
@@ -0,0 +1,310 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "netbuilder/FigureOfMerit/PersistentTValueCache.h"
+
+#include <boost/filesystem.hpp>
+
+#include <cerrno>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define NETBUILDER_PERSISTENT_TVALUE_CACHE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace NetBuilder { namespace FigureOfMerit {
+
+/** 
+ * Slot of the hash table. A slot is empty if its key is zero.
+ */ 
+struct PersistentTValueCache::Slot
+{
+    uint64_t first; // first half of the key
+    uint64_t second; // second half of the key
+    uint32_t tValue; // t-value
+    uint32_t check; // checksum of the key and of the t-value
+};
+
+constexpr size_t PersistentTValueCache::DefaultCapacity;
+
+namespace {
+    // identifies the files of the cache and their format
+    const uint64_t Magic = 0x31304356544e4c00ULL;
+
+    // size of the header of the file: magic number, then number of slots
+    const size_t HeaderBytes = 64;
+
+    // number of slots probed to find or store an entry
+    const size_t MaxProbes = 8;
+
+    uint64_t mix(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    PersistentTValueCache::Hash combine(const PersistentTValueCache::Hash& hash, uint64_t value)
+    {
+        return PersistentTValueCache::Hash{mix(hash.first ^ (value + 0x9e3779b97f4a7c15ULL)), 
+                                           mix(((hash.second << 23) | (hash.second >> 41)) + value * 0xc2b2ae3d27d4eb4fULL + 1)};
+    }
+
+    uint32_t checksum(uint64_t first, uint64_t second, uint32_t tValue)
+    {
+        return (uint32_t) (mix(first ^ mix(second ^ tValue)) | 1); // never zero
+    }
+
+#ifdef NETBUILDER_PERSISTENT_TVALUE_CACHE_MMAP
+    // creates an empty cache file at path, if there is none; the file is written under a temporary 
+    // name and then renamed, so that other processes never see a file without its header
+    void create(const std::string& path, size_t capacity, size_t bytes)
+    {
+        boost::system::error_code ec;
+        auto tmpPath = boost::filesystem::path(path);
+        tmpPath += boost::filesystem::unique_path(".%%%%-%%%%-%%%%.tmp", ec);
+        if (ec)
+        {
+            return;
+        }
+        const int fd = ::open(tmpPath.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+        if (fd < 0)
+        {
+            return;
+        }
+        const uint64_t header[2] = {Magic, capacity};
+        const bool written = ::ftruncate(fd, (off_t) bytes) == 0 && ::pwrite(fd, header, sizeof(header), 0) == (ssize_t) sizeof(header);
+        ::close(fd);
+        if (written && !boost::filesystem::exists(path, ec))
+        {
+            boost::filesystem::rename(tmpPath, path, ec);
+        }
+        boost::filesystem::remove(tmpPath, ec);
+    }
+#endif
+}
+
+namespace {
+    struct State {
+        std::mutex mutex;
+        std::string path = [] {
+            const char* env = std::getenv("LATNETBUILDER_TVALUE_CACHE");
+            return std::string(env ? env : "");
+        }();
+        bool opened = false; // whether the file at path was opened
+        std::unique_ptr<PersistentTValueCache> cache;
+    };
+
+    State& state()
+    {
+        static State s;
+        return s;
+    }
+}
+
+void PersistentTValueCache::setPath(std::string path)
+{
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.path = std::move(path);
+    s.opened = false;
+    s.cache.reset();
+}
+
+PersistentTValueCache* PersistentTValueCache::instance()
+{
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (!s.opened)
+    {
+        s.cache.reset(s.path.empty() ? nullptr : open(s.path));
+        s.opened = true;
+    }
+    return s.cache.get();
+}
+
+PersistentTValueCache::PersistentTValueCache(void* data, size_t bytes, size_t capacity):
+    m_data(data),
+    m_bytes(bytes),
+    m_slots(reinterpret_cast<Slot*>(static_cast<char*>(data) + HeaderBytes)),
+    m_capacity(capacity)
+{}
+
+PersistentTValueCache::~PersistentTValueCache()
+{
+#ifdef NETBUILDER_PERSISTENT_TVALUE_CACHE_MMAP
+    ::munmap(m_data, m_bytes);
+#endif
+}
+
+PersistentTValueCache* PersistentTValueCache::open(const std::string& path)
+{
+#ifdef NETBUILDER_PERSISTENT_TVALUE_CACHE_MMAP
+    int fd = ::open(path.c_str(), O_RDWR);
+    if (fd < 0 && errno == ENOENT)
+    {
+        create(path, DefaultCapacity, HeaderBytes + DefaultCapacity * sizeof(Slot));
+        fd = ::open(path.c_str(), O_RDWR);
+    }
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || (size_t) info.st_size < HeaderBytes)
+    {
+        ::close(fd);
+        return nullptr;
+    }
+    const size_t bytes = (size_t) info.st_size;
+    void* data = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    const uint64_t* header = static_cast<const uint64_t*>(data);
+    const size_t capacity = (size_t) header[1];
+    // do not use a file which is not a cache file, or whose format is different
+    if (header[0] != Magic || capacity == 0 || (capacity & (capacity - 1)) != 0 || bytes != HeaderBytes + capacity * sizeof(Slot))
+    {
+        ::munmap(data, bytes);
+        return nullptr;
+    }
+    return new PersistentTValueCache(data, bytes, capacity);
+#else
+    (void)path;
+    return nullptr;
+#endif
+}
+
+PersistentTValueCache::Hash PersistentTValueCache::hash(const GeneratingMatrix& matrix)
+{
+    Hash res{matrix.nRows(), matrix.nCols()};
+    for (unsigned int i = 0; i < matrix.nRows(); ++i)
+    {
+        const GeneratingMatrix::Row& row = matrix[i];
+        for (size_t j = row.find_first(); j != GeneratingMatrix::Row::npos; j = row.find_next(j))
+        {
+            res = combine(res, ((uint64_t) i << 32) | j);
+        }
+        res = combine(res, ~(uint64_t) 0); // end of the row
+    }
+    return res;
+}
+
+PersistentTValueCache::Hash PersistentTValueCache::key(const std::vector<Hash>& matrixHashes, const Projection& projection, unsigned int nRows, unsigned int nCols)
+{
+    Hash res{0x74u, 0x76u}; // t-values
+    res = combine(res, ((uint64_t) nRows << 32) | nCols);
+    res = combine(res, projection.size());
+    for (auto coord : projection)
+    {
+        res = combine(res, matrixHashes[coord].first);
+        res = combine(res, matrixHashes[coord].second);
+    }
+    return res;
+}
+
+PersistentTValueCache::Hash PersistentTValueCache::levelKey(const Hash& key, unsigned int level)
+{
+    return combine(key, ((uint64_t) 0x6c76u << 32) | level);
+}
+
+bool PersistentTValueCache::find(const Hash& key, unsigned int& tValue) const
+{
+    // the slots are shared with other threads and processes: the checksum is read first and read again 
+    // after the entry, so that an entry which is being written is never returned
+    const uint64_t first = key.first | 1; // nonzero key
+    for (size_t k = 0; k < MaxProbes; ++k)
+    {
+        Slot& slot = m_slots[(key.second + k) & (m_capacity - 1)];
+        const uint32_t check = __atomic_load_n(&slot.check, __ATOMIC_ACQUIRE);
+        const uint64_t slotFirst = __atomic_load_n(&slot.first, __ATOMIC_RELAXED);
+        if (slotFirst == 0)
+        {
+            return false;
+        }
+        const uint64_t slotSecond = __atomic_load_n(&slot.second, __ATOMIC_RELAXED);
+        const uint32_t slotTValue = __atomic_load_n(&slot.tValue, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&slot.check, __ATOMIC_RELAXED) != check)
+        {
+            continue;
+        }
+        if (slotFirst == first && slotSecond == key.second && check == checksum(first, key.second, slotTValue))
+        {
+            tValue = slotTValue;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PersistentTValueCache::find(const Hash& key, std::vector<unsigned int>& tValues) const
+{
+    for (unsigned int level = 0; level < tValues.size(); ++level)
+    {
+        if (!find(levelKey(key, level), tValues[level]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void PersistentTValueCache::insert(const Hash& key, unsigned int tValue)
+{
+    const uint64_t first = key.first | 1; // nonzero key
+    Slot* target = &m_slots[key.second & (m_capacity - 1)]; // replaced if all the probed slots are used
+    for (size_t k = 0; k < MaxProbes; ++k)
+    {
+        Slot& slot = m_slots[(key.second + k) & (m_capacity - 1)];
+        const uint64_t slotFirst = __atomic_load_n(&slot.first, __ATOMIC_RELAXED);
+        if (slotFirst == 0 || (slotFirst == first && __atomic_load_n(&slot.second, __ATOMIC_RELAXED) == key.second))
+        {
+            target = &slot;
+            break;
+        }
+    }
+    // invalidate the slot before the entry is written, and publish the checksum last
+    __atomic_store_n(&target->check, 0u, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&target->first, first, __ATOMIC_RELAXED);
+    __atomic_store_n(&target->second, key.second, __ATOMIC_RELAXED);
+    __atomic_store_n(&target->tValue, (uint32_t) tValue, __ATOMIC_RELAXED);
+    __atomic_store_n(&target->check, checksum(first, key.second, tValue), __ATOMIC_RELEASE);
+}
+
+void PersistentTValueCache::insert(const Hash& key, const std::vector<unsigned int>& tValues)
+{
+    for (unsigned int level = 0; level < tValues.size(); ++level)
+    {
+        insert(levelKey(key, level), tValues[level]);
+    }
+}
+
+}}
@@ -21,6 +21,8 @@
 
 namespace NetBuilder{
 
+    constexpr unsigned int RankComputer::NoPivot;
+
     RankComputer::RankComputer(unsigned int nCols)
     {
         reset(nCols);
@@ -35,126 +37,127 @@ namespace NetBuilder{
         #ifdef DEBUG_ROW_REDUCER
         m_baseMatrix = GeneratingMatrix(0, m_nCols);
         #endif
-        m_columnsWithoutPivot.clear();
-        for(unsigned int j = 0; j < nCols; ++j)
-        {
-            m_columnsWithoutPivot.insert(m_columnsWithoutPivot.end(), j);
-        }
-        m_rowsWithoutPivot.clear();
-        m_pivotsColRowPositions.clear();
-        m_pivotsRowColPositions.clear();
+        m_rank = 0;
+        m_pivotRowOfCol.assign(nCols, NoPivot);
+        m_pivotColOfRow.clear();
         m_rowOperations.resize(0,m_nCols);
     }
 
     unsigned int RankComputer::computeRank() const
     {
-        return (unsigned int) m_pivotsColRowPositions.size();
+        return m_rank;
     }
 
     std::vector<unsigned int> RankComputer::computeRanks(unsigned int firstCol, unsigned int numCol) const
     {
         unsigned int rank = 0;
-        std::vector<unsigned int> ranks(numCol, rank);
-        unsigned int lastCol = firstCol;
-
-        for(const auto& colRow : m_pivotsColRowPositions)
+        for(unsigned int col = 0; col < std::min(firstCol, m_nCols); ++col)
         {
-            if(colRow.first >= firstCol+numCol)
-            {
-                break;
-            }
-
-            for(unsigned int col = lastCol; col < colRow.first ; ++col)
-            {
-                ranks[col-firstCol] = rank;
-            }
-
-            rank+=1;
-
-            if (colRow.first >= firstCol)
+            if (m_pivotRowOfCol[col] != NoPivot)
             {
-                lastCol = colRow.first;
+                ++rank;
             }
         }
 
-        for(unsigned int col = lastCol; col < firstCol + numCol; ++col)
+        std::vector<unsigned int> ranks(numCol);
+        for(unsigned int col = firstCol; col < firstCol + numCol; ++col)
         {
+            if (col < m_nCols && m_pivotRowOfCol[col] != NoPivot)
+            {
+                ++rank;
+            }
             ranks[col-firstCol] = rank;
         }
 
         return ranks;
     }
 
-    unsigned int RankComputer::pivotRowAndFindNewPivot(unsigned int rowIndex)
+    std::map<unsigned int, unsigned int> RankComputer::getPivots() const
     {
-
-        for( const auto& colRowPivot : m_pivotsColRowPositions)
+        std::map<unsigned int, unsigned int> pivots;
+        for(unsigned int row = 0; row < m_nRows; ++row)
         {
-            
-            if (m_redMat(rowIndex,colRowPivot.first)) // if required, use the pivot to flip this bit
+            if (m_pivotColOfRow[row] != NoPivot)
             {
-                m_rowOperations[rowIndex] = m_rowOperations[rowIndex] ^ m_rowOperations[colRowPivot.second];
-                m_redMat[rowIndex] = m_redMat[rowIndex] ^ m_redMat[colRowPivot.second];
+                pivots.emplace_hint(pivots.end(), row, m_pivotColOfRow[row]);
             }
         }
+        return pivots;
+    }
 
-        unsigned int newPivotColPosition = m_nCols;
-        for(std::set<unsigned int>::iterator it = m_columnsWithoutPivot.begin(); it != m_columnsWithoutPivot.end(); ++it)
+    unsigned int RankComputer::pivotRowAndFindNewPivot(unsigned int rowIndex)
+    {
+        GeneratingMatrix::Row& row = m_redMat[rowIndex];
+
+        // The pivot rows are zero on the other pivot columns, so using a pivot does not change the bits
+        // of the row on the pivot columns on its left.
+        for(auto col = row.find_first(); col != GeneratingMatrix::Row::npos; col = row.find_next(col))
         {
-            if(m_redMat(rowIndex, *it))
+            const unsigned int pivotRow = m_pivotRowOfCol[col];
+            if (pivotRow != NoPivot) // use the pivot to flip this bit
             {
-                newPivotColPosition = *it;
-                m_columnsWithoutPivot.erase(it); // this column will have a pivot
-                break;
+                m_rowOperations[rowIndex] ^= m_rowOperations[pivotRow];
+                row ^= m_redMat[pivotRow];
             }
         }
 
+        // the row is now zero on all the pivot columns, so its first bit is on a column without pivot
+        const auto first = row.find_first();
+        const unsigned int newPivotColPosition = (first == GeneratingMatrix::Row::npos) ? m_nCols : (unsigned int) first;
+
         if (newPivotColPosition < m_nCols) // if such a pivot exists
         {
-            
-            m_pivotsColRowPositions[newPivotColPosition] = rowIndex;
-            m_pivotsRowColPositions[rowIndex] = newPivotColPosition;
+            m_pivotRowOfCol[newPivotColPosition] = rowIndex;
+            m_pivotColOfRow[rowIndex] = newPivotColPosition;
+            ++m_rank;
             for(unsigned int i = 0; i < m_nRows; ++i) // for each rowIndex above the inserted rowIndex
             {
                 if(i != rowIndex && m_redMat(i, newPivotColPosition)) // if required, use the rowIndex to flip this bit
                 {
-                    m_redMat[i] = m_redMat[i] ^ m_redMat[rowIndex];
-                    m_rowOperations[i] = m_rowOperations[i] ^ m_rowOperations[rowIndex];
+                    m_redMat[i] ^= row;
+                    m_rowOperations[i] ^= m_rowOperations[rowIndex];
                 }
             }
-            
-        }
-        else // if not
-        {
-            m_rowsWithoutPivot.push_back(rowIndex);
         }
         return newPivotColPosition;
     }
 
 
     void RankComputer::addRow(GeneratingMatrix newRow)
+    {
+        addRow(newRow[0]);
+    }
+
+    void RankComputer::addRow(const GeneratingMatrix::Row& newRow)
     {
         unsigned int row = m_nRows;
         ++m_nRows;
         m_rowOperations.resize(m_nRows, m_nRows);
         m_rowOperations.flip(row,row);
 
+        m_redMat.resize(m_nRows, m_nCols);
+        m_redMat[row] = newRow;
         #ifdef DEBUG_ROW_REDUCER
-        m_baseMatrix.stackBelow(newRow);
-        m_redMat.stackBelow(newRow);
-        #else
-        m_redMat.stackBelow(std::move(newRow));
+        m_baseMatrix.resize(m_nRows, m_nCols);
+        m_baseMatrix[row] = newRow;
         #endif
 
+        m_pivotColOfRow.push_back(NoPivot);
+
         pivotRowAndFindNewPivot(row);
 
-        if (m_pivotsColRowPositions.size() < m_nRows)
+        if (m_rank < m_nRows)
         {
             m_smallestFullRank = m_nCols + 1;
         }
         else
         {
-            m_smallestFullRank = (*std::max_element(m_pivotsColRowPositions.begin(), m_pivotsColRowPositions.end())).first + 1;
+            unsigned int lastPivotCol = m_nCols - 1;
+            while (m_pivotRowOfCol[lastPivotCol] == NoPivot)
+            {
+                --lastPivotCol;
+            }
+            m_smallestFullRank = lastPivotCol + 1;
         }
 
     }
@@ -170,45 +173,46 @@ namespace NetBuilder{
 
         unsigned int col = m_nCols;
         ++m_nCols;
+        m_pivotRowOfCol.push_back(NoPivot);
 
         unsigned int newPivotRowPosition = m_nRows;
-        for(std::list<unsigned int>::iterator it = m_rowsWithoutPivot.begin(); it != m_rowsWithoutPivot.end(); ++it)
+        for(unsigned int i = 0; i < m_nRows; ++i) // first row without pivot
         {
-            if(m_redMat(*it,col))
+            if(m_pivotColOfRow[i] == NoPivot && m_redMat(i,col))
             {
-                newPivotRowPosition = *it;
-                m_rowsWithoutPivot.erase(it); // this row will have a pivot
+                newPivotRowPosition = i;
                 break;
             }
         }
 
         if(newPivotRowPosition < m_nRows)
         {
-            m_pivotsColRowPositions[col] = newPivotRowPosition;
-            m_pivotsRowColPositions[newPivotRowPosition] = col;
+            m_pivotRowOfCol[col] = newPivotRowPosition;
+            m_pivotColOfRow[newPivotRowPosition] = col;
+            ++m_rank;
 
             for(unsigned int i = 0; i < m_nRows; ++i)
             {
                 if( i != newPivotRowPosition && m_redMat(i,col))
                 {
                     m_redMat.flip(i,col);
-                    m_rowOperations[i] = m_rowOperations[i] ^ m_rowOperations[newPivotRowPosition];
+                    m_rowOperations[i] ^= m_rowOperations[newPivotRowPosition];
                 }
             }
         }
-        else
-        {
-            m_columnsWithoutPivot.insert(col);
-        }
     }
 
     void RankComputer::replaceRow(unsigned int rowIndex, GeneratingMatrix&& newRow, int verbose)
     {
-        auto rowIndexColPivPos = m_pivotsRowColPositions.find(rowIndex);
+        replaceRow(rowIndex, newRow[0], verbose);
+    }
+
+    void RankComputer::replaceRow(unsigned int rowIndex, const GeneratingMatrix::Row& newRow, int verbose)
+    {
+        const unsigned int colPositionPivot = m_pivotColOfRow[rowIndex];
 
-        if (rowIndexColPivPos != m_pivotsRowColPositions.end())
+        if (colPositionPivot != NoPivot)
         {
-            unsigned int colPositionPivot = (*rowIndexColPivPos).second;
             unsigned int firstRowToDepivot = 0;
             if (m_rowOperations(rowIndex, rowIndex) != 1){
                 for(unsigned int tmpIndex = 0; tmpIndex < m_nRows; ++tmpIndex)
@@ -217,18 +221,16 @@ namespace NetBuilder{
                         m_redMat.swapRows(tmpIndex, rowIndex);
                         m_rowOperations.swapRows(tmpIndex, rowIndex);
 
-                        auto tmpIndexPivPos = m_pivotsRowColPositions.find(tmpIndex);
-                        int tmpIndexColPivPos;
-                        if(tmpIndexPivPos != m_pivotsRowColPositions.end())
+                        const unsigned int tmpIndexColPivPos = m_pivotColOfRow[tmpIndex];
+                        if(tmpIndexColPivPos != NoPivot)
                         {
-                            tmpIndexColPivPos = (*tmpIndexPivPos).second;
-                            m_pivotsColRowPositions.erase(tmpIndexColPivPos);
-                            m_columnsWithoutPivot.insert(tmpIndexColPivPos);
+                            m_pivotRowOfCol[tmpIndexColPivPos] = NoPivot;
+                            --m_rank;
                         }
                         
-                        m_pivotsRowColPositions.erase(rowIndex);
-                        m_pivotsColRowPositions[colPositionPivot] = tmpIndex;
-                        m_pivotsRowColPositions[tmpIndex] = colPositionPivot;
+                        m_pivotColOfRow[rowIndex] = NoPivot;
+                        m_pivotRowOfCol[colPositionPivot] = tmpIndex;
+                        m_pivotColOfRow[tmpIndex] = colPositionPivot;
                         
                         firstRowToDepivot = tmpIndex+1;
                         break;
@@ -236,26 +238,24 @@ namespace NetBuilder{
                 }
             }
             else{
-                m_pivotsRowColPositions.erase(rowIndex);
-                m_pivotsColRowPositions.erase(colPositionPivot);
-                m_columnsWithoutPivot.insert(colPositionPivot);
+                m_pivotColOfRow[rowIndex] = NoPivot;
+                m_pivotRowOfCol[colPositionPivot] = NoPivot;
+                --m_rank;
             }
 
             for(unsigned int i = firstRowToDepivot; i < m_nRows; ++i)
             {
                 if(i!=rowIndex && m_rowOperations(i,rowIndex))
                 {
-                    m_redMat[i] = m_redMat[i] ^ m_redMat[rowIndex];
-                    m_rowOperations[i] = m_rowOperations[i] ^ m_rowOperations[rowIndex];
+                    m_redMat[i] ^= m_redMat[rowIndex];
+                    m_rowOperations[i] ^= m_rowOperations[rowIndex];
                 }
             }
         }
 
+        m_redMat[rowIndex] = newRow; // in place, the row has the same size
         #ifdef DEBUG_ROW_REDUCER
-        m_redMat[rowIndex] = newRow[0];
-        m_baseMatrix[rowIndex] = newRow[0];
-        #else
-        m_redMat[rowIndex] = std::move(newRow[0]);
+        m_baseMatrix[rowIndex] = newRow;
         #endif
 
         m_rowOperations[rowIndex].reset();
@@ -326,9 +326,16 @@ void RankComputer::check(){
         }
     }
 
-    for (const auto& colRow : m_pivotsColRowPositions){
-        unsigned int col = colRow.first;
-        unsigned int row = colRow.second;
+    unsigned int rank = 0;
+    for (unsigned int col = 0; col < m_nCols; col++){
+        unsigned int row = m_pivotRowOfCol[col];
+        if (row == NoPivot){
+            continue;
+        }
+        ++rank;
+        if (m_pivotColOfRow[row] != col){
+            throw std::runtime_error("Row and column pivot tables are incompatible.");
+        }
         for (unsigned int i=0; i < m_nRows; i++){
             if (m_redMat(i, col) != (i == row)){
                 throw std::runtime_error("A column containing a pivot has not the good property.");
@@ -338,31 +345,22 @@ void RankComputer::check(){
         check_col[col] = 1;
     }
 
-    for (const auto& rowCol : m_pivotsRowColPositions){
-        unsigned int row = rowCol.first;
-        unsigned int col = rowCol.second;
-        if (check_row[row] != 1 || check_col[col] != 1){
-            throw std::runtime_error("RowCol and ColRow maps are incompatible (1) .");
+    for (unsigned int row = 0; row < m_nRows; row++){
+        unsigned int col = m_pivotColOfRow[row];
+        if (col != NoPivot && (check_row[row] != 1 || check_col[col] != 1)){
+            throw std::runtime_error("Row and column pivot tables are incompatible.");
         }
-        if (m_pivotsColRowPositions[col] != row){
-            throw std::runtime_error("RowCol and ColRow maps are incompatible (2) .");
+        if (col == NoPivot){
+            check_row[row] = 1;
         }
     }
-    if (m_pivotsColRowPositions.size() != m_pivotsRowColPositions.size()){
-        throw std::runtime_error("RowCol and ColRow maps are incompatible (3) .");
+    if (rank != m_rank){
+        throw std::runtime_error("Wrong rank.");
     }
-
-    for (const auto& col: m_columnsWithoutPivot){
-        if (check_col[col] != 0){
-            throw std::runtime_error("Column without pivot in pivot map.");
+    for (unsigned int col = 0; col < m_nCols; col++){
+        if (m_pivotRowOfCol[col] == NoPivot){
+            check_col[col] = 1;
         }
-        check_col[col] = 1;
-    }
-    for (const auto& row: m_rowsWithoutPivot){
-        if (check_row[row] != 0){
-            throw std::runtime_error("Row without pivot in pivot map.");
-        }
-        check_row[row] = 1;
     }
 
     for (const auto& r: check_row){
@@ -33,7 +33,7 @@ getmsb (unsigned long long x)
 
 typedef GeneratingMatrix GeneratingMatrix;
 
-unsigned int SchmidMethod::computeTValue(std::vector<GeneratingMatrix> matrices, unsigned int maxTValuesSubProj, int verbose=0)
+unsigned int SchmidMethod::computeTValue(GeneratingMatricesView matrices, unsigned int maxTValuesSubProj, int verbose=0)
 {
     unsigned int m = matrices[0].nCols();
     unsigned int s = (unsigned int)matrices.size();
@@ -53,7 +53,7 @@ unsigned int SchmidMethod::computeTValue(std::vector<GeneratingMatrix> matrices,
         do
         { 
             std::vector<unsigned int> comp = compMaker.currentComposition();
-            std::vector<GeneratingMatrix::Row*> tmp(k);
+            std::vector<const GeneratingMatrix::Row*> tmp(k);
             unsigned int idx = 0;
             for(Dimension coord = 0; coord < s; ++coord)
             {
@@ -78,7 +78,7 @@ unsigned int SchmidMethod::computeTValue(std::vector<GeneratingMatrix> matrices,
     return maxTValuesSubProj;
 }
 
-std::vector<unsigned int> SchmidMethod::computeTValue(std::vector<GeneratingMatrix> matrices, const std::vector<unsigned int>& maxTValuesSubProj, int verbose=0)
+std::vector<unsigned int> SchmidMethod::computeTValue(GeneratingMatricesView matrices, const std::vector<unsigned int>& maxTValuesSubProj, int verbose=0)
 {
     unsigned int m = matrices[0].nCols();
     unsigned int s = (unsigned int)matrices.size();
@@ -103,7 +103,7 @@ std::vector<unsigned int> SchmidMethod::computeTValue(std::vector<GeneratingMatr
         do
         {
             std::vector<unsigned int> comp = compMaker.currentComposition();
-            std::vector<GeneratingMatrix::Row*> tmp(k);
+            std::vector<const GeneratingMatrix::Row*> tmp(k);
             unsigned int idx = 0;
             for(Dimension coord = 0; coord < s; ++coord)
             {
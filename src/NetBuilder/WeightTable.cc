@@ -0,0 +1,211 @@
+// This file is part of LatNet Builder.
+//
+// Copyright (C) 2012-2021  The LatNet Builder author's, supervised by Pierre L'Ecuyer, Universite de Montreal.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "netbuilder/WeightTable.h"
+#include "latbuilder/CombinedWeights.h"
+#include "latbuilder/Interlaced/IPODWeights.h"
+
+#include "latticetester/OrderDependentWeights.h"
+#include "latticetester/ProductWeights.h"
+#include "latticetester/PODWeights.h"
+#include "latticetester/ProjectionDependentWeights.h"
+
+#include <algorithm>
+
+namespace NetBuilder
+{
+
+namespace {
+
+    /**
+     * Appends to \c out the projections made of \c coordinate and of up to
+     * <tt>maxCardinal - 1</tt> coordinates among \c coords (sorted), whose
+     * cardinal \c k is such that <tt>orders[k]</tt> is \c true.
+     */
+    void enumerate(
+            const std::vector<Projection::value_type>& coords,
+            Projection::value_type coordinate,
+            const std::vector<bool>& orders,
+            std::vector<Projection>& out)
+    {
+        const size_t maxCardinal = orders.size() - 1;
+        // indices in coords of the coordinates of the current projection
+        std::vector<size_t> stack;
+        while (true) {
+            if (orders[stack.size() + 1]) {
+                Projection proj{coordinate};
+                for (const auto i : stack)
+                    proj.insert(coords[i]);
+                out.push_back(std::move(proj));
+            }
+            // next subset in lexicographic order
+            if (stack.size() + 1 < maxCardinal && (stack.empty() ? 0 : stack.back() + 1) < coords.size()) {
+                stack.push_back(stack.empty() ? 0 : stack.back() + 1);
+                continue;
+            }
+            while (!stack.empty() && stack.back() + 1 == coords.size())
+                stack.pop_back();
+            if (stack.empty())
+                break;
+            ++stack.back();
+        }
+    }
+
+    /**
+     * Returns the base weights of \c weights if they are interlaced POD
+     * weights, or \c nullptr otherwise.
+     */
+    const LatticeTester::PODWeights* interlacedBaseWeights(const LatticeTester::Weights& weights)
+    {
+        using namespace LatBuilder::Interlaced;
+        using namespace LatBuilder::Kernel;
+        if (const auto w = dynamic_cast<const IPODWeights<IAAlpha>*>(&weights))
+            return &w->getBaseWeights();
+        if (const auto w = dynamic_cast<const IPODWeights<IB>*>(&weights))
+            return &w->getBaseWeights();
+        if (const auto w = dynamic_cast<const IPODWeights<ICAlpha>*>(&weights))
+            return &w->getBaseWeights();
+        return nullptr;
+    }
+
+    /**
+     * Appends to \c out the projections with largest coordinate \c coordinate
+     * and cardinal at most \c maxCardinal that can have a nonzero weight.
+     */
+    void addCandidates(
+            const LatticeTester::Weights& weights,
+            Dimension coordinate,
+            unsigned int maxCardinal,
+            std::vector<Projection>& out)
+    {
+        if (maxCardinal == 0)
+            return;
+
+        if (const auto w = dynamic_cast<const LatBuilder::CombinedWeights*>(&weights)) {
+            for (const auto& component : w->list())
+                addCandidates(*component, coordinate, maxCardinal, out);
+            return;
+        }
+
+        if (const auto w = dynamic_cast<const LatticeTester::ProjectionDependentWeights*>(&weights)) {
+            if (coordinate < w->getSize()) {
+                for (const auto& pw : w->getWeightsForLargestIndex(coordinate)) {
+                    if (pw.first.size() <= maxCardinal)
+                        out.emplace_back(pw.first);
+                }
+            }
+            return;
+        }
+
+        const LatticeTester::ProductWeights* productWeights = nullptr;
+        const LatticeTester::OrderDependentWeights* orderWeights = nullptr;
+        Dimension interlacing = 1;
+        if (const auto w = interlacedBaseWeights(weights)) {
+            // the weight of u is the base weight of {j / d : j in u}, where d
+            // is the interlacing factor, times nonzero correction weights
+            productWeights = &w->getProductWeights();
+            orderWeights = &w->getOrderDependentWeights();
+            interlacing = weights.interlacingFactor();
+        }
+        else if (const auto w = dynamic_cast<const LatticeTester::PODWeights*>(&weights)) {
+            productWeights = &w->getProductWeights();
+            orderWeights = &w->getOrderDependentWeights();
+        }
+        else {
+            productWeights = dynamic_cast<const LatticeTester::ProductWeights*>(&weights);
+            orderWeights = dynamic_cast<const LatticeTester::OrderDependentWeights*>(&weights);
+        }
+
+        if (productWeights && productWeights->getWeightForCoordinate(coordinate / interlacing) == 0.0)
+            return;
+
+        std::vector<Projection::value_type> coords;
+        for (Dimension j = 0; j < coordinate; ++j) {
+            if (!productWeights || productWeights->getWeightForCoordinate(j / interlacing) != 0.0)
+                coords.push_back((Projection::value_type) j);
+        }
+
+        // a projection of cardinal k has a base projection of cardinal
+        // between ceil(k / d) and k
+        std::vector<bool> orders(maxCardinal + 1, true);
+        orders[0] = false;
+        if (orderWeights) {
+            for (unsigned int k = 1; k <= maxCardinal; ++k) {
+                orders[k] = false;
+                for (unsigned int order = (k + interlacing - 1) / interlacing; order <= k && !orders[k]; ++order)
+                    orders[k] = orderWeights->getWeightForOrder(order) != 0.0;
+            }
+        }
+
+        enumerate(coords, (Projection::value_type) coordinate, orders, out);
+    }
+}
+
+//===========================================================================
+
+WeightTable::WeightTable(const LatticeTester::Weights& weights, unsigned int maxCardinal):
+    m_weights(weights),
+    m_maxCardinal(maxCardinal)
+{}
+
+//===========================================================================
+
+const WeightTable::Layer& WeightTable::layer(Dimension coordinate)
+{
+    if (coordinate >= m_compiled.size() || !m_compiled[coordinate])
+        compile(coordinate);
+    return m_layers[coordinate];
+}
+
+//===========================================================================
+
+Real WeightTable::weight(const Projection& projection)
+{
+    if (projection.empty() || projection.size() > m_maxCardinal)
+        return m_weights.getWeight(projection.coordinates());
+
+    const Layer& entries = layer(projection.back());
+    const auto it = std::lower_bound(entries.begin(), entries.end(), projection,
+            [] (const Entry& entry, const Projection& proj) { return entry.first < proj; });
+    return (it != entries.end() && it->first == projection) ? it->second : 0.0;
+}
+
+//===========================================================================
+
+void WeightTable::compile(Dimension coordinate)
+{
+    if (coordinate >= m_layers.size()) {
+        m_layers.resize(coordinate + 1);
+        m_compiled.resize(coordinate + 1, false);
+    }
+
+    std::vector<Projection> candidates;
+    addCandidates(m_weights, coordinate, m_maxCardinal, candidates);
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    Layer& entries = m_layers[coordinate];
+    entries.clear();
+    for (auto& proj : candidates) {
+        const Real weight = m_weights.getWeight(proj.coordinates());
+        if (weight != 0.0)
+            entries.emplace_back(std::move(proj), weight);
+    }
+    entries.shrink_to_fit();
+    m_compiled[coordinate] = true;
+}
+
+}
@@ -30,9 +30,13 @@
 #include "netbuilder/Parser/NetConstructionParser.h"
 #include "netbuilder/Parser/OutputStyleParser.h"
 #include "netbuilder/Task/Task.h"
+#include "netbuilder/FigureOfMerit/PersistentTValueCache.h"
 
 #include "latbuilder/Parser/Common.h"
 #include "latbuilder/SizeParam.h"
+#include "latbuilder/Kernel/ValuesCache.h"
+#include "latbuilder/OutOfCore.h"
+#include "latbuilder/fftw++.h"
 
 // using namespace LatBuilder;
 // using TextStream::operator<<;
@@ -69,12 +73,13 @@ makeOptionsDescription()
    ("exploration-method,e", po::value<std::string>(),
     "(required) exploration method; possible values:\n"
     "  evaluation:<net_description>\n" 
+    "  batch-evaluation:<file>\n"
     "  exhaustive\n"
     "  random:<r>\n"
     "  full-CBC\n"
     "  random-CBC:<r>\n"
     "  mixed-CBC:<r>:<nb_full>\n"
-    "where <net_description> is a net description (see documentation), <r> is the number of samples, and <nb_full> the number of coordinates for which full CBC exploration is used.")
+    "where <net_description> is a net description (see documentation), <file> contains net descriptions separated by blank or comment lines, or - for the standard input (evaluated in parallel, results output as a table), <r> is the number of samples, and <nb_full> the number of coordinates for which full CBC exploration is used.")
    ("figure-of-merit,f", po::value<std::string>(),
     "(required) type of figure of merit; format: <merit>\n"
     "  and where <merit> is one of:\n"
@@ -130,7 +135,13 @@ makeOptionsDescription()
     ("output-style,O", po::value<std::string>()->default_value(""),
     "(optional) TBD\n")
     ("merit-digits-displayed", po::value<unsigned int>()->default_value(0),
-    "(optional) number of significant figures to use when displaying merit values\n");
+    "(optional) number of significant figures to use when displaying merit values\n")
+    ("kernel-cache", po::value<std::string>(),
+    "(optional) path to a folder where the kernel values are saved and reused by later runs with the same kernel and size parameter (default: value of the LATNETBUILDER_KERNEL_CACHE environment variable, if set)\n")
+    ("out-of-core", po::value<std::string>(),
+    "(optional) path to a folder where the large vectors of kernel values and states are stored in memory-mapped files, to search lattices whose vectors do not fit in memory (default: value of the LATNETBUILDER_OUT_OF_CORE environment variable, if set)\n")
+    ("tvalue-cache", po::value<std::string>(),
+    "(optional) path to a file where the t-values of the projections are saved and reused by later runs with the same generating matrices (default: value of the LATNETBUILDER_TVALUE_CACHE environment variable, if set)\n");
 
    return desc;
 }
@@ -228,6 +239,10 @@ void TaskOutput(const Task::Task &task, std::string outputFolder, OutputStyle ou
 
 int main(int argc, const char *argv[])
 {
+#ifdef FFTWXX_USE_THREADS
+   // must precede any other call to FFTW
+   fftw<Real>::init_threads();
+#endif
 
    try {
      using namespace std::chrono;
@@ -250,6 +265,15 @@ int main(int argc, const char *argv[])
         // global variable
         merit_digits_displayed = opt["merit-digits-displayed"].as<unsigned int>();
 
+        if (opt.count("kernel-cache") >= 1)
+          LatBuilder::Kernel::ValuesCache::setDirectory(opt["kernel-cache"].as<std::string>());
+
+        if (opt.count("out-of-core") >= 1)
+          LatBuilder::OutOfCore::setDirectory(opt["out-of-core"].as<std::string>());
+
+        if (opt.count("tvalue-cache") >= 1)
+          NetBuilder::FigureOfMerit::PersistentTValueCache::setPath(opt["tvalue-cache"].as<std::string>());
+
         std::string s_multilevel = opt["multilevel"].as<std::string>();
         std::string s_construction = opt["construction"].as<std::string>();
         std::string s_outputStyle = opt["output-style"].as<std::string>();